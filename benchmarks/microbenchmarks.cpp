@@ -0,0 +1,448 @@
+/*
+ *  Copyright © 2018-2023 Hennadii Chernyshchyk <genaloner@gmail.com>
+ *
+ *  This file is part of QOnlineTranslator.
+ *
+ *  QOnlineTranslator is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  QOnlineTranslator is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with QOnlineTranslator. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "mockengineserver.h"
+#include "qlanguagedetector.h"
+#include "qonlinetranslator.h"
+#include "qonlinetranslator_p.h"
+#include "qonlinetts.h"
+#include "qpercentencoder.h"
+#include "qscripthistogram.h"
+#include "qtranslationresult.h"
+#include "qtransliterator.h"
+#include "recordedreply.h"
+
+#include <QDir>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMetaEnum>
+#include <QTest>
+#include <QUrl>
+#include <QUrlQuery>
+
+#include <tuple>
+
+// Benchmarks for functions that do not depend on the network
+class QOnlineTranslatorMicroBenchmarks : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void getSplitIndex_data();
+    void getSplitIndex();
+
+    void splitText_data();
+    void splitText();
+
+    void languageApiCode_data();
+    void languageApiCode();
+
+    void language_data();
+    void language();
+
+    void isSupportTranslation_data();
+    void isSupportTranslation();
+
+    void detectLanguage_data();
+    void detectLanguage();
+
+    void scriptHistogram_data();
+    void scriptHistogram();
+
+    void percentEncode_data();
+    void percentEncode();
+
+    void transliterate_data();
+    void transliterate();
+
+    void parseResponse_data();
+    void parseResponse();
+
+    void toJson_data();
+    void toJson();
+
+    void generateUrls_data();
+    void generateUrls();
+
+private:
+    static void addTextRows();
+    static void addEngineColumn();
+    static QString generateText(const QString &sample, int size);
+    static QVector<QOnlineTranslator::Language> languages();
+};
+
+void QOnlineTranslatorMicroBenchmarks::getSplitIndex_data()
+{
+    addTextRows();
+}
+
+void QOnlineTranslatorMicroBenchmarks::getSplitIndex()
+{
+    QFETCH(QString, text);
+
+    int splitIndex = 0;
+    QBENCHMARK {
+        splitIndex = QOnlineTranslatorPrivateAccess::getSplitIndex(text, QOnlineTranslatorPrivateAccess::s_googleTranslateLimit);
+    }
+    QVERIFY(splitIndex > 0);
+}
+
+void QOnlineTranslatorMicroBenchmarks::splitText_data()
+{
+    addTextRows();
+}
+
+// Splits the whole text the same way as buildSplitNetworkRequest() does
+void QOnlineTranslatorMicroBenchmarks::splitText()
+{
+    QFETCH(QString, text);
+
+    int parts = 0;
+    QBENCHMARK {
+        parts = 0;
+        QString unsendedText = text;
+        while (!unsendedText.isEmpty()) {
+            const int splitIndex = QOnlineTranslatorPrivateAccess::getSplitIndex(unsendedText, QOnlineTranslatorPrivateAccess::s_googleTranslateLimit);
+            unsendedText = unsendedText.mid(splitIndex);
+            ++parts;
+        }
+    }
+    QVERIFY(parts > 0);
+}
+
+void QOnlineTranslatorMicroBenchmarks::languageApiCode_data()
+{
+    addEngineColumn();
+}
+
+void QOnlineTranslatorMicroBenchmarks::languageApiCode()
+{
+    QFETCH(QOnlineTranslator::Engine, engine);
+
+    const QVector<QOnlineTranslator::Language> allLanguages = languages();
+    int supported = 0;
+    QBENCHMARK {
+        supported = 0;
+        for (QOnlineTranslator::Language lang : allLanguages) {
+            if (!QOnlineTranslatorPrivateAccess::languageApiCode(engine, lang).isEmpty())
+                ++supported;
+        }
+    }
+    QVERIFY(supported > 0);
+}
+
+void QOnlineTranslatorMicroBenchmarks::language_data()
+{
+    addEngineColumn();
+}
+
+void QOnlineTranslatorMicroBenchmarks::language()
+{
+    QFETCH(QOnlineTranslator::Engine, engine);
+
+    // Parse back every code that the engine uses
+    QStringList codes;
+    for (QOnlineTranslator::Language lang : languages()) {
+        const QString code = QOnlineTranslatorPrivateAccess::languageApiCode(engine, lang);
+        if (!code.isEmpty())
+            codes.append(code);
+    }
+
+    int recognized = 0;
+    QBENCHMARK {
+        recognized = 0;
+        for (const QString &code : qAsConst(codes)) {
+            if (QOnlineTranslatorPrivateAccess::language(engine, code) != QOnlineTranslator::NoLanguage)
+                ++recognized;
+        }
+    }
+    QCOMPARE(recognized, codes.size());
+}
+
+void QOnlineTranslatorMicroBenchmarks::isSupportTranslation_data()
+{
+    addEngineColumn();
+}
+
+void QOnlineTranslatorMicroBenchmarks::isSupportTranslation()
+{
+    QFETCH(QOnlineTranslator::Engine, engine);
+
+    const QVector<QOnlineTranslator::Language> allLanguages = languages();
+    int supported = 0;
+    QBENCHMARK {
+        supported = 0;
+        for (QOnlineTranslator::Language lang : allLanguages) {
+            if (QOnlineTranslator::isSupportTranslation(engine, lang))
+                ++supported;
+        }
+    }
+    QVERIFY(supported > 0);
+}
+
+void QOnlineTranslatorMicroBenchmarks::detectLanguage_data()
+{
+    addTextRows();
+}
+
+void QOnlineTranslatorMicroBenchmarks::detectLanguage()
+{
+    QFETCH(QString, text);
+
+    QLanguageDetector::Result result;
+    QBENCHMARK {
+        result = QLanguageDetector::detect(text);
+    }
+    QVERIFY(result.confidence >= 0 && result.confidence <= 1);
+}
+
+void QOnlineTranslatorMicroBenchmarks::scriptHistogram_data()
+{
+    addTextRows();
+}
+
+void QOnlineTranslatorMicroBenchmarks::scriptHistogram()
+{
+    QFETCH(QString, text);
+
+    QScriptHistogram histogram;
+    QBENCHMARK {
+        histogram = QScriptHistogram(text);
+    }
+    QCOMPARE(histogram.size(), text.size());
+}
+
+void QOnlineTranslatorMicroBenchmarks::percentEncode_data()
+{
+    addTextRows();
+}
+
+void QOnlineTranslatorMicroBenchmarks::percentEncode()
+{
+    QFETCH(QString, text);
+
+    QByteArray buffer;
+    QBENCHMARK {
+        buffer.resize(0);
+        QPercentEncoder::append(buffer, text);
+    }
+    QCOMPARE(buffer, QUrl::toPercentEncoding(text));
+}
+
+void QOnlineTranslatorMicroBenchmarks::transliterate_data()
+{
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<QOnlineTranslator::Language>("language");
+
+    const QList<std::tuple<const char *, QString, QOnlineTranslator::Language>> samples = {
+        {"russian", QStringLiteral("Съешь же ещё этих мягких французских булок, да выпей чаю. "), QOnlineTranslator::Russian},
+        {"greek", QStringLiteral("Ξεσκεπάζω την ψυχοφθόρα βδελυγμία. "), QOnlineTranslator::Greek},
+        {"hindi", QStringLiteral("ऋषियों को सताने वाले दुष्ट राक्षसों के राजा रावण का सर्वनाश करने वाले विष्णुवतार भगवान श्रीराम। "), QOnlineTranslator::Hindi},
+    };
+    for (const auto &[name, sample, language] : samples) {
+        for (int size : {100, 10000, 1000000})
+            QTest::addRow("%s, %d", name, size) << generateText(sample, size) << language;
+    }
+}
+
+void QOnlineTranslatorMicroBenchmarks::transliterate()
+{
+    QFETCH(QString, text);
+    QFETCH(QOnlineTranslator::Language, language);
+
+    QString translit;
+    QBENCHMARK {
+        translit = QTransliterator::transliterate(text, language);
+    }
+    QVERIFY(!translit.isEmpty());
+}
+
+// Bundled responses are synthetic samples written by hand in the RecordingNetworkAccessManager format,
+// set QONLINETRANSLATOR_RECORDINGS to the directory of real captures to benchmark them instead
+void QOnlineTranslatorMicroBenchmarks::parseResponse_data()
+{
+    QTest::addColumn<QString>("endpoint");
+    QTest::addColumn<QUrl>("url");
+    QTest::addColumn<QByteArray>("body");
+
+    const QByteArray recordingsPath = qgetenv("QONLINETRANSLATOR_RECORDINGS");
+    const QDir dir(recordingsPath.isEmpty() ? QStringLiteral(QONLINETRANSLATOR_SAMPLES_DIR) : QString::fromLocal8Bit(recordingsPath));
+    for (const QFileInfo &fileInfo : dir.entryInfoList({QStringLiteral("*.json")}, QDir::Files, QDir::Name)) {
+        QFile file(fileInfo.filePath());
+        if (!file.open(QIODevice::ReadOnly))
+            continue;
+
+        const QJsonObject recording = QJsonDocument::fromJson(file.readAll()).object();
+        const QUrl url(recording.value(QStringLiteral("url")).toString());
+        const QString endpoint = MockEngineServer::endpointName(url.path());
+        if (!QOnlineTranslatorPrivateAccess::canParse(endpoint))
+            continue;
+
+        QTest::newRow(qPrintable(fileInfo.completeBaseName())) << endpoint << url << recording.value(QStringLiteral("body")).toString().toUtf8();
+    }
+}
+
+void QOnlineTranslatorMicroBenchmarks::parseResponse()
+{
+    QFETCH(QString, endpoint);
+    QFETCH(QUrl, url);
+    QFETCH(QByteArray, body);
+
+    QOnlineTranslator translator;
+    QTranslationResultData &data = QOnlineTranslatorPrivateAccess::resultData(translator);
+    data.source = QStringLiteral("Hello");
+    data.sourceLang = QOnlineTranslator::English;
+    data.translationLang = QOnlineTranslator::Russian;
+    QOnlineTranslatorPrivateAccess::setUiLanguage(translator, QOnlineTranslator::English);
+
+    // Dictionary is looked up by the language pair of the request
+    const QStringList dictionary = QUrlQuery(url).queryItemValue(QStringLiteral("dict")).split('-');
+    if (dictionary.size() == 2) {
+        data.sourceLang = QOnlineTranslatorPrivateAccess::language(QOnlineTranslator::Yandex, dictionary.constFirst());
+        data.translationLang = QOnlineTranslatorPrivateAccess::language(QOnlineTranslator::Yandex, dictionary.constLast());
+    }
+
+    // Reply creation is included, parsers consume the body
+    QBENCHMARK {
+        auto *reply = new RecordedReply(body);
+        QOnlineTranslatorPrivateAccess::parseReply(translator, endpoint, reply);
+        delete reply;
+    }
+    QCOMPARE(translator.error(), QOnlineTranslator::NoError);
+}
+
+void QOnlineTranslatorMicroBenchmarks::toJson_data()
+{
+    QTest::addColumn<int>("types");
+    QTest::addColumn<int>("entries");
+
+    QTest::newRow("word") << 3 << 10;
+    QTest::newRow("common word") << 10 << 100;
+    QTest::newRow("large dictionary") << 50 << 1000;
+}
+
+void QOnlineTranslatorMicroBenchmarks::toJson()
+{
+    QFETCH(int, types);
+    QFETCH(int, entries);
+
+    QOnlineTranslator translator;
+    QTranslationResultData &data = QOnlineTranslatorPrivateAccess::resultData(translator);
+    data.source = QStringLiteral("Hello");
+    data.translation = QStringLiteral("Привет");
+    for (int type = 0; type < types; ++type) {
+        const QString typeName = QStringLiteral("type %1").arg(type);
+        QVector<QOption> &options = data.translationOptions[typeName];
+        QVector<QExample> &examples = data.examples[typeName];
+        for (int i = 0; i < entries; ++i) {
+            options.append({QStringLiteral("option %1").arg(i), QStringLiteral("masculine"), {QStringLiteral("hello"), QStringLiteral("hi"), QStringLiteral("greetings")}});
+            examples.append({QStringLiteral("Hello, world %1!").arg(i), QStringLiteral("used as a greeting or to begin a phone conversation")});
+        }
+    }
+
+    QByteArray json;
+    QBENCHMARK {
+        json = translator.toJson().toJson(QJsonDocument::Compact);
+    }
+    QVERIFY(!json.isEmpty());
+}
+
+void QOnlineTranslatorMicroBenchmarks::generateUrls_data()
+{
+    QTest::addColumn<QOnlineTranslator::Engine>("engine");
+    QTest::addColumn<QString>("text");
+
+    for (QOnlineTranslator::Engine engine : {QOnlineTranslator::Google, QOnlineTranslator::Yandex}) {
+        const QByteArray engineName = QMetaEnum::fromType<QOnlineTranslator::Engine>().valueToKey(engine);
+        for (int size : {100, 10000, 1000000}) {
+            QTest::addRow("%s, latin, %d", engineName.constData(), size) << engine << generateText(QStringLiteral("The quick brown fox jumps over the lazy dog. "), size);
+            QTest::addRow("%s, cyrillic, %d", engineName.constData(), size) << engine << generateText(QStringLiteral("Съешь же ещё этих мягких французских булок. "), size);
+        }
+    }
+}
+
+void QOnlineTranslatorMicroBenchmarks::generateUrls()
+{
+    QFETCH(QOnlineTranslator::Engine, engine);
+    QFETCH(QString, text);
+
+    int urls = 0;
+    QBENCHMARK {
+        // Generated URLs are appended to the previous ones, so create a new object every time
+        QOnlineTts tts;
+        tts.generateUrls(text, engine, QOnlineTranslator::English);
+        urls = tts.media().size();
+    }
+    QVERIFY(urls > 0);
+}
+
+void QOnlineTranslatorMicroBenchmarks::addTextRows()
+{
+    QTest::addColumn<QString>("text");
+
+    // Different scripts and delimiters check different branches of the split
+    const QList<QPair<const char *, QString>> samples = {
+        {"latin", QStringLiteral("The quick brown fox jumps over the lazy dog. ")},
+        {"cyrillic", QStringLiteral("Съешь же ещё этих мягких французских булок, да выпей чаю. ")},
+        {"cjk", QStringLiteral("我能吞下玻璃而不伤身体。")},
+        {"arabic", QStringLiteral("أنا قادر على أكل الزجاج و هذا لا يؤلمني. ")},
+        {"no delimiters", QStringLiteral("abcdefghijklmnopqrstuvwxyz")},
+    };
+    for (const auto &sample : samples) {
+        for (int size : {100, 10000, 1000000, 10000000})
+            QTest::addRow("%s, %d", sample.first, size) << generateText(sample.second, size);
+    }
+}
+
+void QOnlineTranslatorMicroBenchmarks::addEngineColumn()
+{
+    QTest::addColumn<QOnlineTranslator::Engine>("engine");
+
+    const QMetaEnum engines = QMetaEnum::fromType<QOnlineTranslator::Engine>();
+    for (int i = 0; i < engines.keyCount(); ++i)
+        QTest::newRow(engines.key(i)) << static_cast<QOnlineTranslator::Engine>(engines.value(i));
+}
+
+QString QOnlineTranslatorMicroBenchmarks::generateText(const QString &sample, int size)
+{
+    QString text;
+    text.reserve(size);
+    while (text.size() < size)
+        text += sample;
+    text.truncate(size);
+    return text;
+}
+
+QVector<QOnlineTranslator::Language> QOnlineTranslatorMicroBenchmarks::languages()
+{
+    QVector<QOnlineTranslator::Language> allLanguages;
+    const QMetaEnum languageEnum = QMetaEnum::fromType<QOnlineTranslator::Language>();
+    for (int i = 0; i < languageEnum.keyCount(); ++i) {
+        const auto lang = static_cast<QOnlineTranslator::Language>(languageEnum.value(i));
+        if (lang != QOnlineTranslator::NoLanguage && lang != QOnlineTranslator::Auto)
+            allLanguages.append(lang);
+    }
+    return allLanguages;
+}
+
+QTEST_GUILESS_MAIN(QOnlineTranslatorMicroBenchmarks)
+
+#include "microbenchmarks.moc"
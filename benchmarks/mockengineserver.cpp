@@ -0,0 +1,358 @@
+/*
+ *  Copyright © 2018-2023 Hennadii Chernyshchyk <genaloner@gmail.com>
+ *
+ *  This file is part of QOnlineTranslator.
+ *
+ *  QOnlineTranslator is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  QOnlineTranslator is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with QOnlineTranslator. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "mockengineserver.h"
+
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPointer>
+#include <QRandomGenerator>
+#include <QTcpSocket>
+#include <QTimer>
+#include <QUrlQuery>
+
+#include <algorithm>
+
+MockEngineServer::MockEngineServer(QObject *parent)
+    : QTcpServer(parent)
+{
+    connect(this, &MockEngineServer::newConnection, this, &MockEngineServer::acceptConnections);
+}
+
+bool MockEngineServer::start(quint16 port)
+{
+    return listen(QHostAddress::LocalHost, port);
+}
+
+QString MockEngineServer::url() const
+{
+    return QStringLiteral("http://127.0.0.1:%1").arg(serverPort());
+}
+
+void MockEngineServer::setLatency(int msecs)
+{
+    m_latency = msecs;
+}
+
+void MockEngineServer::setErrorRate(qreal rate)
+{
+    m_errorRate = rate;
+}
+
+int MockEngineServer::loadRecordings(const QString &directory)
+{
+    const QDir dir(directory);
+    for (const QString &fileName : dir.entryList({QStringLiteral("*.json")}, QDir::Files, QDir::Name)) {
+        QFile file(dir.filePath(fileName));
+        if (!file.open(QIODevice::ReadOnly))
+            continue;
+
+        const QJsonObject recording = QJsonDocument::fromJson(file.readAll()).object();
+        const QUrl url(recording.value(QStringLiteral("url")).toString());
+        if (endpointName(url.path()).isEmpty())
+            continue;
+
+        Response &recordedResponse = m_recordings[requestKey(url, recording.value(QStringLiteral("requestBody")).toString().toUtf8())];
+        recordedResponse.status = recording.value(QStringLiteral("status")).toInt(200);
+        recordedResponse.contentType = recording.value(QStringLiteral("contentType")).toString().toUtf8();
+        recordedResponse.body = recording.value(QStringLiteral("body")).toString().toUtf8();
+    }
+
+    return m_recordings.size();
+}
+
+int MockEngineServer::requestsCount() const
+{
+    return m_requestsCount;
+}
+
+qint64 MockEngineServer::bytesSent() const
+{
+    return m_bytesSent;
+}
+
+QString MockEngineServer::endpointName(const QString &path)
+{
+    if (path == QLatin1String("/translate_a/single"))
+        return QStringLiteral("google-translate");
+    if (path == QLatin1String("/api/v1/tr.json/translate"))
+        return QStringLiteral("yandex-translate");
+    if (path == QLatin1String("/translit/translit"))
+        return QStringLiteral("yandex-translit");
+    if (path == QLatin1String("/dicservice.json/lookupMultiple"))
+        return QStringLiteral("yandex-dictionary");
+    if (path == QLatin1String("/translator"))
+        return QStringLiteral("bing-credentials");
+    if (path == QLatin1String("/ttranslatev3"))
+        return QStringLiteral("bing-translate");
+    if (path == QLatin1String("/tlookupv3"))
+        return QStringLiteral("bing-dictionary");
+    if (path == QLatin1String("/detect"))
+        return QStringLiteral("libre-detect");
+    if (path == QLatin1String("/translate"))
+        return QStringLiteral("libre-translate");
+    if (path.startsWith(QLatin1String("/api/v1/")))
+        return QStringLiteral("lingva-translate");
+    return {};
+}
+
+void MockEngineServer::acceptConnections()
+{
+    while (hasPendingConnections()) {
+        QTcpSocket *socket = nextPendingConnection();
+        connect(socket, &QTcpSocket::readyRead, this, &MockEngineServer::readRequests);
+        connect(socket, &QTcpSocket::disconnected, this, [this, socket] {
+            m_buffers.remove(socket);
+            socket->deleteLater();
+        });
+    }
+}
+
+void MockEngineServer::readRequests()
+{
+    auto *socket = qobject_cast<QTcpSocket *>(sender());
+    QByteArray &buffer = m_buffers[socket];
+    buffer += socket->readAll();
+
+    // Process all complete requests in the buffer
+    forever {
+        const int headersEnd = buffer.indexOf("\r\n\r\n");
+        if (headersEnd == -1)
+            return;
+
+        const QList<QByteArray> lines = buffer.left(headersEnd).split('\n');
+        const QList<QByteArray> requestLine = lines.first().trimmed().split(' ');
+        if (requestLine.size() < 2) {
+            socket->disconnectFromHost();
+            return;
+        }
+
+        int contentLength = 0;
+        bool closeConnection = false;
+        for (int i = 1; i < lines.size(); ++i) {
+            const QByteArray line = lines.at(i).trimmed();
+            const int separator = line.indexOf(':');
+            const QByteArray name = line.left(separator).trimmed().toLower();
+            const QByteArray value = line.mid(separator + 1).trimmed();
+            if (name == "content-length")
+                contentLength = value.toInt();
+            else if (name == "connection")
+                closeConnection = value.toLower() == "close";
+        }
+
+        const int bodyBegin = headersEnd + 4;
+        if (buffer.size() < bodyBegin + contentLength)
+            return;
+
+        const QByteArray body = buffer.mid(bodyBegin, contentLength);
+        const QUrl url = QUrl::fromEncoded(requestLine.at(1));
+        buffer.remove(0, bodyBegin + contentLength);
+
+        ++m_requestsCount;
+        sendResponse(socket, response(requestLine.first(), url, body), closeConnection);
+        if (closeConnection)
+            return;
+    }
+}
+
+MockEngineServer::Response MockEngineServer::response(const QByteArray &method, const QUrl &url, const QByteArray &body) const
+{
+    if (m_errorRate > 0 && QRandomGenerator::global()->generateDouble() < m_errorRate)
+        return {503, "text/plain", "Service Unavailable"};
+
+    const QString endpoint = endpointName(url.path());
+    if (endpoint.isEmpty() || (method != "GET" && method != "POST"))
+        return {404, "text/plain", "Not Found"};
+
+    const auto recording = m_recordings.constFind(requestKey(url, body));
+    if (recording != m_recordings.cend())
+        return *recording;
+
+    return syntheticResponse(endpoint, url, body);
+}
+
+void MockEngineServer::sendResponse(QTcpSocket *socket, const Response &response, bool closeConnection)
+{
+    QByteArray reason;
+    switch (response.status) {
+    case 200:
+        reason = "OK";
+        break;
+    case 404:
+        reason = "Not Found";
+        break;
+    case 503:
+        reason = "Service Unavailable";
+        break;
+    default:
+        reason = "Status";
+        break;
+    }
+
+    QByteArray data = "HTTP/1.1 " + QByteArray::number(response.status) + ' ' + reason + "\r\n"
+        + "Content-Type: " + response.contentType + "\r\n"
+        + "Content-Length: " + QByteArray::number(response.body.size()) + "\r\n"
+        + "Connection: " + (closeConnection ? "close" : "keep-alive") + "\r\n\r\n"
+        + response.body;
+    m_bytesSent += response.body.size();
+
+    const QPointer<QTcpSocket> guardedSocket = socket;
+    auto write = [guardedSocket, data = qMove(data), closeConnection] {
+        if (guardedSocket == nullptr)
+            return;
+
+        guardedSocket->write(data);
+        if (closeConnection)
+            guardedSocket->disconnectFromHost();
+    };
+
+    if (m_latency > 0)
+        QTimer::singleShot(m_latency, socket, write);
+    else
+        write();
+}
+
+// Identifies the request by its parameters, except the ones that change every session
+QString MockEngineServer::requestKey(const QUrl &url, const QByteArray &body)
+{
+    static const QStringList volatileParameters = {QStringLiteral("ucid"), QStringLiteral("IG"), QStringLiteral("IID"), QStringLiteral("token"), QStringLiteral("key"), QStringLiteral("api_key")};
+    auto isVolatile = [](const QPair<QString, QString> &parameter) {
+        return volatileParameters.contains(parameter.first);
+    };
+
+    QList<QPair<QString, QString>> parameters = QUrlQuery(url).queryItems(QUrl::FullyDecoded);
+    parameters += QUrlQuery(QString::fromUtf8(body)).queryItems(QUrl::FullyDecoded);
+    parameters.erase(std::remove_if(parameters.begin(), parameters.end(), isVolatile), parameters.end());
+    std::sort(parameters.begin(), parameters.end());
+
+    QString key = url.path(QUrl::FullyDecoded);
+    for (const auto &[name, value] : qAsConst(parameters))
+        key += '\n' + name + '=' + value;
+    return key;
+}
+
+MockEngineServer::Response MockEngineServer::syntheticResponse(const QString &endpoint, const QUrl &url, const QByteArray &body)
+{
+    // Text can be passed in query or in form data
+    const QUrlQuery query(url);
+    const QUrlQuery form(QString::fromUtf8(body));
+    auto parameter = [&query, &form](const QString &name) {
+        if (form.hasQueryItem(name))
+            return form.queryItemValue(name, QUrl::FullyDecoded);
+        return query.queryItemValue(name, QUrl::FullyDecoded);
+    };
+
+    if (endpoint == QLatin1String("google-translate")) {
+        // Fill only the requested sections at the same positions as Google does
+        const QString text = parameter(QStringLiteral("q"));
+        const QString sourceLang = parameter(QStringLiteral("sl"));
+        const QStringList sections = query.allQueryItemValues(QStringLiteral("dt"));
+        QJsonArray response;
+        for (int i = 0; i < 15; ++i)
+            response.append(QJsonValue::Null);
+
+        if (sections.contains(QLatin1String("t"))) {
+            QJsonArray translation{QJsonArray{text, text, QJsonValue::Null, QJsonValue::Null, 10}};
+            if (sections.contains(QLatin1String("rm")))
+                translation.append(QJsonArray{QJsonValue::Null, QJsonValue::Null, text, text});
+            response[0] = translation;
+        }
+        if (sections.contains(QLatin1String("bd")))
+            response[1] = QJsonArray{QJsonArray{QStringLiteral("noun"), QJsonArray{text}, QJsonArray{QJsonArray{text, QJsonArray{text}, QJsonValue::Null, 1.0}}}};
+        response[2] = sourceLang == QLatin1String("auto") ? QStringLiteral("en") : sourceLang;
+        if (sections.contains(QLatin1String("at")))
+            response[5] = QJsonArray{QJsonArray{text, QJsonValue::Null, QJsonArray{QJsonArray{text, 1000, true, false}}, QJsonArray{QJsonArray{0, text.size()}}, text, 0, 0}};
+        if (sections.contains(QLatin1String("ld")))
+            response[8] = QJsonArray{QJsonArray{sourceLang}, QJsonValue::Null, QJsonArray{1.0}, QJsonArray{sourceLang}};
+        if (sections.contains(QLatin1String("ss")))
+            response[11] = QJsonArray{QJsonArray{QStringLiteral("noun"), QJsonArray{QJsonArray{QJsonArray{text}, QStringLiteral("m_en_us0001.001")}}, text}};
+        if (sections.contains(QLatin1String("md")))
+            response[12] = QJsonArray{QJsonArray{QStringLiteral("noun"), QJsonArray{QJsonArray{text, QStringLiteral("m_en_us0001.001"), text}}}};
+        if (sections.contains(QLatin1String("ex")))
+            response[13] = QJsonArray{QJsonArray{QJsonArray{QStringLiteral("<b>%1</b>").arg(text), QJsonValue::Null, QJsonValue::Null, QJsonValue::Null, QJsonValue::Null, QStringLiteral("m_en_us0001.001")}}};
+        if (sections.contains(QLatin1String("rw")))
+            response[14] = QJsonArray{QJsonArray{text}};
+        return {200, "application/json; charset=utf-8", QJsonDocument(response).toJson(QJsonDocument::Compact)};
+    }
+
+    if (endpoint == QLatin1String("yandex-translate")) {
+        QString lang = parameter(QStringLiteral("lang"));
+        if (!lang.contains('-'))
+            lang.prepend(QStringLiteral("en-"));
+        const QJsonObject response{{"code", 200}, {"lang", lang}, {"text", QJsonArray{parameter(QStringLiteral("text"))}}};
+        return {200, "application/json; charset=utf-8", QJsonDocument(response).toJson(QJsonDocument::Compact)};
+    }
+
+    if (endpoint == QLatin1String("yandex-translit"))
+        return {200, "application/json; charset=utf-8", '"' + parameter(QStringLiteral("text")).toUtf8() + '"'};
+
+    if (endpoint == QLatin1String("yandex-dictionary")) {
+        const QString text = parameter(QStringLiteral("text"));
+        const QJsonObject example{{"text", text}, {"tr", QJsonArray{QJsonObject{{"text", text}}}}};
+        const QJsonObject word{{"text", text}, {"gen", QJsonObject{{"text", "m"}}}, {"mean", QJsonArray{QJsonObject{{"text", text}}}}, {"ex", QJsonArray{example}}};
+        const QJsonObject typeOfSpeech{{"pos", QJsonObject{{"text", "noun"}}}, {"ts", text}, {"tr", QJsonArray{word}}};
+        const QJsonObject response{{parameter(QStringLiteral("dict")), QJsonObject{{"regular", QJsonArray{typeOfSpeech}}}}};
+        return {200, "application/json; charset=utf-8", QJsonDocument(response).toJson(QJsonDocument::Compact)};
+    }
+
+    if (endpoint == QLatin1String("bing-credentials")) {
+        return {200, "text/html; charset=utf-8",
+                "<html><body data-iid=\"translator.5023\"><script>"
+                "var params_AbusePreventionHelper = [1700000000000,\"MockToken\",3600000];"
+                "_G={IG:\"MOCKIG\"};"
+                "</script></body></html>"};
+    }
+
+    if (endpoint == QLatin1String("bing-translate")) {
+        const QString text = parameter(QStringLiteral("text"));
+        const QJsonObject translation{{"text", text}, {"to", parameter(QStringLiteral("to"))}, {"transliteration", QJsonObject{{"text", text}}}};
+        const QJsonObject response{{"detectedLanguage", QJsonObject{{"language", "en"}, {"score", 1.0}}}, {"translations", QJsonArray{translation}}};
+        return {200, "application/json; charset=utf-8", QJsonDocument(QJsonArray{response}).toJson(QJsonDocument::Compact)};
+    }
+
+    if (endpoint == QLatin1String("bing-dictionary")) {
+        const QString text = parameter(QStringLiteral("text"));
+        const QJsonObject translation{{"posTag", "NOUN"}, {"displayTarget", text}, {"backTranslations", QJsonArray{QJsonObject{{"displayText", text}}}}};
+        const QJsonObject response{{"translations", QJsonArray{translation}}};
+        return {200, "application/json; charset=utf-8", QJsonDocument(QJsonArray{response}).toJson(QJsonDocument::Compact)};
+    }
+
+    if (endpoint == QLatin1String("libre-detect")) {
+        const QJsonObject response{{"confidence", 90.0}, {"language", "en"}};
+        return {200, "application/json", QJsonDocument(QJsonArray{response}).toJson(QJsonDocument::Compact)};
+    }
+
+    if (endpoint == QLatin1String("libre-translate")) {
+        const QJsonObject response{{"translatedText", parameter(QStringLiteral("q"))}};
+        return {200, "application/json", QJsonDocument(response).toJson(QJsonDocument::Compact)};
+    }
+
+    // Lingva passes text as the last path segment
+    const QString path = url.path(QUrl::FullyEncoded);
+    const QString text = QUrl::fromPercentEncoding(path.mid(path.lastIndexOf('/') + 1).toUtf8());
+    const QJsonObject info{{"pronunciation", QJsonObject{{"translation", text}}},
+                           {"extraTranslations", QJsonArray{QJsonObject{{"type", "noun"}, {"list", QJsonArray{QJsonObject{{"word", text}, {"meanings", QJsonArray{text}}}}}}}},
+                           {"definitions", QJsonArray{QJsonObject{{"type", "noun"}, {"list", QJsonArray{QJsonObject{{"definition", text}, {"example", text}}}}}}}};
+    const QJsonObject response{{"translation", text}, {"info", info}};
+    return {200, "application/json", QJsonDocument(response).toJson(QJsonDocument::Compact)};
+}
@@ -0,0 +1,134 @@
+/*
+ *  Copyright © 2018-2023 Hennadii Chernyshchyk <genaloner@gmail.com>
+ *
+ *  This file is part of QOnlineTranslator.
+ *
+ *  QOnlineTranslator is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  QOnlineTranslator is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with QOnlineTranslator. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef MOCKENGINESERVER_H
+#define MOCKENGINESERVER_H
+
+#include <QHash>
+#include <QTcpServer>
+
+class QTcpSocket;
+
+/**
+ * @brief Local HTTP stand-in for the online engines
+ *
+ * Imitates Google, Yandex, Bing, LibreTranslate and Lingva endpoints on a single local port.
+ * By default it answers with synthetic responses that echo the source text,
+ * or with the responses captured by RecordingNetworkAccessManager if loaded with loadRecordings().
+ * Point QOnlineTranslator to it with QOnlineTranslator::setEngineUrl().
+ */
+class MockEngineServer : public QTcpServer
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(MockEngineServer)
+
+public:
+    explicit MockEngineServer(QObject *parent = nullptr);
+
+    /**
+     * @brief Start listening on localhost
+     *
+     * @param port port to listen, 0 to pick a free one
+     * @return `true` on success
+     */
+    bool start(quint16 port = 0);
+
+    /**
+     * @brief Server URL
+     *
+     * @return base URL to pass to QOnlineTranslator::setEngineUrl()
+     */
+    QString url() const;
+
+    /**
+     * @brief Set delay before sending each response
+     *
+     * @param msecs delay in milliseconds
+     */
+    void setLatency(int msecs);
+
+    /**
+     * @brief Set probability of answering with "503 Service Unavailable"
+     *
+     * @param rate probability in range [0, 1]
+     */
+    void setErrorRate(qreal rate);
+
+    /**
+     * @brief Replay captured responses instead of synthetic ones
+     *
+     * Responses are matched by the request path and parameters, except the ones that change every session.
+     * Requests without a recorded response are answered with synthetic responses.
+     *
+     * @param directory directory with files written by RecordingNetworkAccessManager
+     * @return number of loaded responses
+     */
+    int loadRecordings(const QString &directory);
+
+    /**
+     * @brief Number of handled requests
+     *
+     * @return number of requests since start
+     */
+    int requestsCount() const;
+
+    /**
+     * @brief Number of response body bytes sent
+     *
+     * @return number of bytes since start
+     */
+    qint64 bytesSent() const;
+
+    /**
+     * @brief Endpoint name
+     *
+     * Used to name recorded responses.
+     *
+     * @param path request path
+     * @return endpoint name or empty string if the path is unknown
+     */
+    static QString endpointName(const QString &path);
+
+private slots:
+    void acceptConnections();
+    void readRequests();
+
+private:
+    struct Response {
+        int status = 200;
+        QByteArray contentType;
+        QByteArray body;
+    };
+
+    Response response(const QByteArray &method, const QUrl &url, const QByteArray &body) const;
+    void sendResponse(QTcpSocket *socket, const Response &response, bool closeConnection);
+
+    static Response syntheticResponse(const QString &endpoint, const QUrl &url, const QByteArray &body);
+    static QString requestKey(const QUrl &url, const QByteArray &body);
+
+    QHash<QTcpSocket *, QByteArray> m_buffers;
+    QHash<QString, Response> m_recordings;
+    qint64 m_bytesSent = 0;
+    qreal m_errorRate = 0;
+    int m_latency = 0;
+    int m_requestsCount = 0;
+};
+
+#endif // MOCKENGINESERVER_H
@@ -0,0 +1,59 @@
+/*
+ *  Copyright © 2018-2023 Hennadii Chernyshchyk <genaloner@gmail.com>
+ *
+ *  This file is part of QOnlineTranslator.
+ *
+ *  QOnlineTranslator is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  QOnlineTranslator is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with QOnlineTranslator. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "mockengineserver.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QTextStream>
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName(QStringLiteral("QOnlineTranslatorMockServer"));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Local HTTP stand-in for Google, Yandex, Bing, LibreTranslate and Lingva"));
+    parser.addHelpOption();
+    const QCommandLineOption portOption({QStringLiteral("p"), QStringLiteral("port")}, QStringLiteral("Port to listen on localhost."), QStringLiteral("port"), QStringLiteral("0"));
+    const QCommandLineOption latencyOption({QStringLiteral("l"), QStringLiteral("latency")}, QStringLiteral("Delay before each response in milliseconds."), QStringLiteral("msecs"), QStringLiteral("0"));
+    const QCommandLineOption errorRateOption({QStringLiteral("e"), QStringLiteral("error-rate")}, QStringLiteral("Probability of answering with 503."), QStringLiteral("rate"), QStringLiteral("0"));
+    const QCommandLineOption replayOption({QStringLiteral("r"), QStringLiteral("replay")}, QStringLiteral("Directory with recorded responses to replay."), QStringLiteral("directory"));
+    parser.addOptions({portOption, latencyOption, errorRateOption, replayOption});
+    parser.process(app);
+
+    MockEngineServer server;
+    server.setLatency(parser.value(latencyOption).toInt());
+    server.setErrorRate(parser.value(errorRateOption).toDouble());
+
+    QTextStream out(stdout);
+    if (parser.isSet(replayOption))
+        out << "Loaded recordings: " << server.loadRecordings(parser.value(replayOption)) << '\n';
+
+    if (!server.start(static_cast<quint16>(parser.value(portOption).toUInt()))) {
+        QTextStream(stderr) << "Unable to listen: " << server.errorString() << '\n';
+        return 1;
+    }
+
+    out << "Listening on " << server.url() << '\n';
+    out.flush();
+
+    return QCoreApplication::exec();
+}
@@ -0,0 +1,48 @@
+/*
+ *  Copyright © 2018-2023 Hennadii Chernyshchyk <genaloner@gmail.com>
+ *
+ *  This file is part of QOnlineTranslator.
+ *
+ *  QOnlineTranslator is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  QOnlineTranslator is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with QOnlineTranslator. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "recordedreply.h"
+
+#include <algorithm>
+
+RecordedReply::RecordedReply(QByteArray body, QObject *parent)
+    : QNetworkReply(parent)
+    , m_body(qMove(body))
+{
+    open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+    setFinished(true);
+}
+
+void RecordedReply::abort()
+{
+}
+
+qint64 RecordedReply::bytesAvailable() const
+{
+    return m_body.size() - m_offset + QNetworkReply::bytesAvailable();
+}
+
+qint64 RecordedReply::readData(char *data, qint64 maxSize)
+{
+    const qint64 size = qMin(maxSize, m_body.size() - m_offset);
+    std::copy_n(m_body.constData() + m_offset, size, data);
+    m_offset += size;
+    return size;
+}
@@ -0,0 +1,55 @@
+/*
+ *  Copyright © 2018-2023 Hennadii Chernyshchyk <genaloner@gmail.com>
+ *
+ *  This file is part of QOnlineTranslator.
+ *
+ *  QOnlineTranslator is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  QOnlineTranslator is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with QOnlineTranslator. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef RECORDEDREPLY_H
+#define RECORDEDREPLY_H
+
+#include <QNetworkReply>
+
+/**
+ * @brief Finished reply with a fixed body
+ *
+ * Feeds the translator parsers with a response without network.
+ */
+class RecordedReply : public QNetworkReply
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(RecordedReply)
+
+public:
+    /**
+     * @brief Create object
+     *
+     * @param body response body to read
+     * @param parent parent object
+     */
+    explicit RecordedReply(QByteArray body, QObject *parent = nullptr);
+
+    void abort() override;
+    qint64 bytesAvailable() const override;
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override;
+
+private:
+    QByteArray m_body;
+    qint64 m_offset = 0;
+};
+
+#endif // RECORDEDREPLY_H
@@ -0,0 +1,82 @@
+/*
+ *  Copyright © 2018-2023 Hennadii Chernyshchyk <genaloner@gmail.com>
+ *
+ *  This file is part of QOnlineTranslator.
+ *
+ *  QOnlineTranslator is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  QOnlineTranslator is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with QOnlineTranslator. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "recordingnetworkaccessmanager.h"
+
+#include "mockengineserver.h"
+
+#include <QBuffer>
+#include <QDir>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QNetworkReply>
+
+RecordingNetworkAccessManager::RecordingNetworkAccessManager(QString directory, QObject *parent)
+    : QNetworkAccessManager(parent)
+    , m_directory(qMove(directory))
+{
+    QDir().mkpath(m_directory);
+}
+
+QNetworkReply *RecordingNetworkAccessManager::createRequest(Operation op, const QNetworkRequest &request, QIODevice *outgoingData)
+{
+    // Outgoing data can be read only once, so keep a copy for the recording
+    QByteArray requestBody;
+    QBuffer *bodyBuffer = nullptr;
+    if (outgoingData != nullptr) {
+        requestBody = outgoingData->readAll();
+        bodyBuffer = new QBuffer(this);
+        bodyBuffer->setData(requestBody);
+        bodyBuffer->open(QIODevice::ReadOnly);
+    }
+
+    QNetworkReply *reply = QNetworkAccessManager::createRequest(op, request, bodyBuffer);
+    if (bodyBuffer != nullptr)
+        bodyBuffer->setParent(reply);
+
+    // Body is peeked before the reply receiver reads it
+    connect(reply, &QNetworkReply::finished, this, [this, reply, requestBody] {
+        saveExchange(reply, requestBody);
+    });
+
+    return reply;
+}
+
+void RecordingNetworkAccessManager::saveExchange(QNetworkReply *reply, const QByteArray &requestBody)
+{
+    const QUrl url = reply->url();
+    QString endpoint = MockEngineServer::endpointName(url.path());
+    if (endpoint.isEmpty())
+        endpoint = QStringLiteral("unknown");
+
+    const QJsonObject exchange{
+        {"body", QString::fromUtf8(reply->peek(reply->bytesAvailable()))},
+        {"contentType", reply->header(QNetworkRequest::ContentTypeHeader).toString()},
+        {"method", reply->operation() == QNetworkAccessManager::PostOperation ? "POST" : "GET"},
+        {"requestBody", QString::fromUtf8(requestBody)},
+        {"status", reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt()},
+        {"url", url.toString(QUrl::FullyEncoded)},
+    };
+
+    QFile file(QDir(m_directory).filePath(QStringLiteral("%1-%2.json").arg(endpoint).arg(++m_exchangesCount, 4, 10, QLatin1Char('0'))));
+    if (file.open(QIODevice::WriteOnly))
+        file.write(QJsonDocument(exchange).toJson());
+}
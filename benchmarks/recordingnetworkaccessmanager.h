@@ -0,0 +1,56 @@
+/*
+ *  Copyright © 2018-2023 Hennadii Chernyshchyk <genaloner@gmail.com>
+ *
+ *  This file is part of QOnlineTranslator.
+ *
+ *  QOnlineTranslator is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  QOnlineTranslator is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with QOnlineTranslator. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef RECORDINGNETWORKACCESSMANAGER_H
+#define RECORDINGNETWORKACCESSMANAGER_H
+
+#include <QNetworkAccessManager>
+
+/**
+ * @brief Network access manager that captures HTTP exchanges to disk
+ *
+ * Pass it to QOnlineTranslator::setNetworkAccessManager() to record real engine responses.
+ * Each exchange is written as a JSON file that can be replayed with MockEngineServer::loadRecordings().
+ */
+class RecordingNetworkAccessManager : public QNetworkAccessManager
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(RecordingNetworkAccessManager)
+
+public:
+    /**
+     * @brief Create object
+     *
+     * @param directory directory to write recordings to, will be created if missing
+     * @param parent parent object
+     */
+    explicit RecordingNetworkAccessManager(QString directory, QObject *parent = nullptr);
+
+protected:
+    QNetworkReply *createRequest(Operation op, const QNetworkRequest &request, QIODevice *outgoingData = nullptr) override;
+
+private:
+    void saveExchange(QNetworkReply *reply, const QByteArray &requestBody);
+
+    QString m_directory;
+    int m_exchangesCount = 0;
+};
+
+#endif // RECORDINGNETWORKACCESSMANAGER_H
@@ -0,0 +1,750 @@
+/*
+ *  Copyright © 2018-2023 Hennadii Chernyshchyk <genaloner@gmail.com>
+ *
+ *  This file is part of QOnlineTranslator.
+ *
+ *  QOnlineTranslator is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  QOnlineTranslator is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with QOnlineTranslator. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "mockengineserver.h"
+#include "qonlinetranslator.h"
+#include "qonlinetranslator_p.h"
+#include "recordedreply.h"
+#include "recordingnetworkaccessmanager.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMetaEnum>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QTextStream>
+#include <QThread>
+#include <QTimer>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <new>
+
+#if defined(Q_OS_LINUX)
+#include <fcntl.h>
+#include <unistd.h>
+#elif defined(Q_OS_MACOS)
+#include <mach/mach.h>
+#elif defined(Q_OS_WIN)
+#include <malloc.h>
+#endif
+
+namespace {
+std::atomic<quint64> s_allocations{0};
+
+// Stand-in server runs in its own thread and its allocations are not counted
+thread_local bool t_countAllocations = true;
+
+void countAllocation()
+{
+    if (t_countAllocations)
+        s_allocations.fetch_add(1, std::memory_order_relaxed);
+}
+} // namespace
+
+#ifdef __GLIBC__
+// Qt containers allocate with malloc() directly, so count every allocation function of the C library
+// (operator new of libstdc++ calls them too)
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+void *__libc_memalign(size_t alignment, size_t size);
+void *__libc_valloc(size_t size);
+void *__libc_pvalloc(size_t size);
+
+void *malloc(size_t size)
+{
+    countAllocation();
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size)
+{
+    countAllocation();
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+    countAllocation();
+    return __libc_realloc(ptr, size);
+}
+
+void *memalign(size_t alignment, size_t size)
+{
+    countAllocation();
+    return __libc_memalign(alignment, size);
+}
+
+void *aligned_alloc(size_t alignment, size_t size)
+{
+    countAllocation();
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void **ptr, size_t alignment, size_t size)
+{
+    if (alignment % sizeof(void *) != 0 || (alignment & (alignment - 1)) != 0)
+        return EINVAL;
+
+    countAllocation();
+    void *memory = __libc_memalign(alignment, size);
+    if (memory == nullptr)
+        return ENOMEM;
+
+    *ptr = memory;
+    return 0;
+}
+
+void *valloc(size_t size)
+{
+    countAllocation();
+    return __libc_valloc(size);
+}
+
+void *pvalloc(size_t size)
+{
+    countAllocation();
+    return __libc_pvalloc(size);
+}
+}
+#else
+// Only operator new can be replaced portably, so allocationsPerTranslation is an approximation here:
+// memory that Qt allocates with malloc() directly is not counted
+namespace {
+void *allocate(std::size_t size)
+{
+    countAllocation();
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void *allocateAligned(std::size_t size, std::align_val_t alignment)
+{
+    countAllocation();
+#ifdef Q_OS_WIN
+    return _aligned_malloc(size == 0 ? 1 : size, static_cast<std::size_t>(alignment));
+#else
+    void *ptr = nullptr;
+    if (posix_memalign(&ptr, std::max(static_cast<std::size_t>(alignment), sizeof(void *)), size == 0 ? 1 : size) != 0)
+        return nullptr;
+    return ptr;
+#endif
+}
+
+void freeAligned(void *ptr)
+{
+#ifdef Q_OS_WIN
+    _aligned_free(ptr);
+#else
+    std::free(ptr);
+#endif
+}
+} // namespace
+
+void *operator new(std::size_t size)
+{
+    if (void *ptr = allocate(size))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size)
+{
+    if (void *ptr = allocate(size))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    return allocate(size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+    return allocate(size);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment)
+{
+    if (void *ptr = allocateAligned(size, alignment))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment)
+{
+    if (void *ptr = allocateAligned(size, alignment))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    return allocateAligned(size, alignment);
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    return allocateAligned(size, alignment);
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, const std::nothrow_t &) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::align_val_t) noexcept
+{
+    freeAligned(ptr);
+}
+
+void operator delete[](void *ptr, std::align_val_t) noexcept
+{
+    freeAligned(ptr);
+}
+
+void operator delete(void *ptr, std::size_t, std::align_val_t) noexcept
+{
+    freeAligned(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t, std::align_val_t) noexcept
+{
+    freeAligned(ptr);
+}
+
+void operator delete(void *ptr, std::align_val_t, const std::nothrow_t &) noexcept
+{
+    freeAligned(ptr);
+}
+
+void operator delete[](void *ptr, std::align_val_t, const std::nothrow_t &) noexcept
+{
+    freeAligned(ptr);
+}
+#endif
+
+namespace {
+constexpr int s_rssSampleInterval = 10; // In milliseconds
+
+struct Configuration {
+    QOnlineTranslator::Engine engine;
+    QString profile;
+    int concurrency;
+    int textSize;
+};
+
+struct Result {
+    int translations = 0;
+    int errors = 0;
+    bool timedOut = false;
+    qreal seconds = 0;
+    QVector<qint64> latencies; // In microseconds
+    quint64 allocations = 0;
+    qint64 bytesReceived = 0;
+    qint64 rssGrowthKb = -1; // Highest sampled resident set size above the one before the run
+};
+
+QString engineName(QOnlineTranslator::Engine engine)
+{
+    return QMetaEnum::fromType<QOnlineTranslator::Engine>().valueToKey(engine);
+}
+
+QStringList splitList(const QString &list)
+{
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+    return list.split(',', Qt::SkipEmptyParts);
+#else
+    return list.split(',', QString::SkipEmptyParts);
+#endif
+}
+
+QList<int> parseIntegers(const QString &list)
+{
+    QList<int> numbers;
+    for (const QString &number : splitList(list))
+        numbers.append(number.toInt());
+    return numbers;
+}
+
+QString generateText(int size)
+{
+    const QString sentence = QStringLiteral("The quick brown fox jumps over the lazy dog. ");
+    QString text;
+    text.reserve(size);
+    while (text.size() < size)
+        text += sentence;
+    text.truncate(size);
+    return text;
+}
+
+qint64 percentile(const QVector<qint64> &sortedValues, qreal fraction)
+{
+    if (sortedValues.isEmpty())
+        return 0;
+
+    const int index = qBound(0, static_cast<int>(std::ceil(fraction * sortedValues.size())) - 1, sortedValues.size() - 1);
+    return sortedValues.at(index);
+}
+
+// Resident set size at the moment, getrusage() reports only the peak of the whole process lifetime
+// Reads without allocating to not affect the allocation counter
+qint64 currentRssKb()
+{
+#if defined(Q_OS_LINUX)
+    const int fd = open("/proc/self/statm", O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+        return -1;
+
+    char buffer[128];
+    const ssize_t size = read(fd, buffer, sizeof(buffer) - 1);
+    close(fd);
+    if (size <= 0)
+        return -1;
+
+    // Second field is the number of resident pages
+    buffer[size] = '\0';
+    char *fields = buffer;
+    std::strtoll(fields, &fields, 10);
+    return std::strtoll(fields, nullptr, 10) * sysconf(_SC_PAGESIZE) / 1024;
+#elif defined(Q_OS_MACOS)
+    mach_task_basic_info info{};
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) != KERN_SUCCESS)
+        return -1;
+    return static_cast<qint64>(info.resident_size / 1024);
+#else
+    return -1;
+#endif
+}
+
+void applyProfile(QOnlineTranslator &translator, const QString &profile)
+{
+    // "plain" requests only the translation itself
+    const bool enabled = profile != QLatin1String("plain");
+    translator.setSourceTranslitEnabled(enabled);
+    translator.setTranslationTranslitEnabled(enabled);
+    translator.setSourceTranscriptionEnabled(enabled);
+    translator.setTranslationOptionsEnabled(enabled);
+    translator.setExamplesEnabled(enabled);
+}
+
+Result run(const Configuration &config, const QString &serverUrl, int requests, int timeout)
+{
+    const QString text = generateText(config.textSize);
+
+    Result result;
+    result.latencies.reserve(requests);
+
+    QObject context;
+    QEventLoop loop;
+    QElapsedTimer timer;
+    QVector<QOnlineTranslator *> translators;
+    QVector<qint64> startTimes(config.concurrency);
+    int started = 0;
+
+    auto startNext = [&](int index) {
+        if (started == requests)
+            return;
+
+        ++started;
+        startTimes[index] = timer.nsecsElapsed();
+        translators[index]->translate(text, config.engine, QOnlineTranslator::Russian, QOnlineTranslator::English, QOnlineTranslator::English);
+    };
+
+    for (int i = 0; i < config.concurrency; ++i) {
+        auto *translator = new QOnlineTranslator(&context);
+        applyProfile(*translator, config.profile);
+        for (QOnlineTranslator::Engine engine : {QOnlineTranslator::Google, QOnlineTranslator::Yandex, QOnlineTranslator::Bing, QOnlineTranslator::LibreTranslate, QOnlineTranslator::Lingva})
+            translator->setEngineUrl(engine, serverUrl);
+
+        // Body is not read yet, because parsing happens in the next state
+        QObject::connect(translator->networkAccessManager(), &QNetworkAccessManager::finished, &context, [&result](QNetworkReply *reply) {
+            result.bytesReceived += reply->bytesAvailable();
+        });
+        QObject::connect(translator, &QOnlineTranslator::finished, &context, [&, translator, i] {
+            result.latencies.append((timer.nsecsElapsed() - startTimes.at(i)) / 1000);
+            if (translator->error() != QOnlineTranslator::NoError)
+                ++result.errors;
+
+            if (++result.translations == requests) {
+                loop.quit();
+                return;
+            }
+
+            // Start the next translation outside of the state machine signal
+            QTimer::singleShot(0, translator, [&startNext, i] {
+                startNext(i);
+            });
+        });
+        translators.append(translator);
+    }
+
+    QTimer::singleShot(timeout, &loop, [&result, &loop] {
+        result.timedOut = true;
+        loop.quit();
+    });
+
+    // Sample memory during the run, since the peak of the previous configurations would hide the current one
+    const qint64 rssBefore = currentRssKb();
+    qint64 rssPeak = rssBefore;
+    QTimer rssTimer;
+    QObject::connect(&rssTimer, &QTimer::timeout, [&rssPeak] {
+        rssPeak = qMax(rssPeak, currentRssKb());
+    });
+    if (rssBefore != -1)
+        rssTimer.start(s_rssSampleInterval);
+
+    const quint64 allocationsBefore = s_allocations.load(std::memory_order_relaxed);
+    timer.start();
+    for (int i = 0; i < config.concurrency; ++i)
+        startNext(i);
+    loop.exec();
+    result.seconds = static_cast<qreal>(timer.nsecsElapsed()) / 1e9;
+    result.allocations = s_allocations.load(std::memory_order_relaxed) - allocationsBefore;
+
+    rssTimer.stop();
+    if (rssBefore != -1)
+        result.rssGrowthKb = qMax(rssPeak, currentRssKb()) - rssBefore;
+
+    for (QOnlineTranslator *translator : qAsConst(translators))
+        translator->abort();
+
+    std::sort(result.latencies.begin(), result.latencies.end());
+    return result;
+}
+
+QJsonObject toJson(const Configuration &config, const Result &result)
+{
+    const int translations = qMax(result.translations, 1);
+    const QJsonObject latency{
+        {"p50", percentile(result.latencies, 0.50) / 1000.0},
+        {"p95", percentile(result.latencies, 0.95) / 1000.0},
+        {"p99", percentile(result.latencies, 0.99) / 1000.0},
+        {"max", result.latencies.isEmpty() ? 0.0 : result.latencies.last() / 1000.0},
+    };
+
+    QJsonObject object{
+        {"allocationsPerTranslation", static_cast<qreal>(result.allocations) / translations},
+        {"bytesReceivedPerTranslation", static_cast<qreal>(result.bytesReceived) / translations},
+        {"concurrency", config.concurrency},
+        {"engine", engineName(config.engine)},
+        {"errors", result.errors},
+        {"latencyMs", latency},
+        {"profile", config.profile},
+        {"requestsPerSecond", result.seconds > 0 ? result.translations / result.seconds : 0.0},
+        {"rssGrowthKb", result.rssGrowthKb},
+        {"seconds", result.seconds},
+        {"textSize", config.textSize},
+        {"timedOut", result.timedOut},
+        {"translations", result.translations},
+    };
+
+    return object;
+}
+
+int record(const QString &directory, const QList<QOnlineTranslator::Engine> &engines, const QString &libreUrl, const QString &lingvaUrl)
+{
+    QTextStream out(stdout);
+    int failures = 0;
+    for (QOnlineTranslator::Engine engine : engines) {
+        if ((engine == QOnlineTranslator::LibreTranslate && libreUrl.isEmpty()) || (engine == QOnlineTranslator::Lingva && lingvaUrl.isEmpty())) {
+            out << engineName(engine) << ": skipped, instance URL is not set\n";
+            continue;
+        }
+
+        QOnlineTranslator translator;
+        translator.setNetworkAccessManager(new RecordingNetworkAccessManager(directory, &translator));
+        translator.setEngineUrl(QOnlineTranslator::LibreTranslate, libreUrl);
+        translator.setEngineUrl(QOnlineTranslator::Lingva, lingvaUrl);
+
+        // Single word to capture dictionary responses and a sentence to capture translation
+        for (const QString &text : {QStringLiteral("Hello"), generateText(200)}) {
+            QEventLoop loop;
+            QObject::connect(&translator, &QOnlineTranslator::finished, &loop, &QEventLoop::quit);
+            translator.translate(text, engine, QOnlineTranslator::Russian, QOnlineTranslator::English, QOnlineTranslator::English);
+            if (translator.isRunning())
+                loop.exec();
+
+            out << engineName(engine) << ": " << (translator.error() == QOnlineTranslator::NoError ? QStringLiteral("recorded") : translator.errorString()) << '\n';
+            if (translator.error() != QOnlineTranslator::NoError)
+                ++failures;
+        }
+    }
+
+    return failures == 0 ? 0 : 1;
+}
+
+// Compares the response sections requested before with the sections the translator requests now
+int compareGoogleSections(const QString &googleUrl, int parses, QJsonArray &results)
+{
+    // Every section that was requested before only the enabled ones were
+    const QString allSections = QStringLiteral("dt=bd&dt=ex&dt=ld&dt=md&dt=rw&dt=rm&dt=ss&dt=t&dt=at&dt=qc");
+
+    QTextStream out(stdout);
+    out << QStringLiteral("%1 %2 %3 %4\n")
+               .arg(QStringLiteral("text"), -8)
+               .arg(QStringLiteral("sections"), -8)
+               .arg(QStringLiteral("bytes"), 8)
+               .arg(QStringLiteral("parse us"), 10);
+
+    QNetworkAccessManager manager;
+    QOnlineTranslator translator;
+    QTranslationResultData &data = QOnlineTranslatorPrivateAccess::resultData(translator);
+    data.sourceLang = QOnlineTranslator::English;
+    data.translationLang = QOnlineTranslator::Russian;
+
+    int failures = 0;
+    const QList<QPair<QString, QString>> texts = {
+        {QStringLiteral("word"), QStringLiteral("say")},
+        {QStringLiteral("word"), QStringLiteral("run")},
+        {QStringLiteral("sentence"), generateText(200)},
+    };
+    for (const auto &[textName, text] : texts) {
+        data.source = text;
+        const QList<QPair<QString, QString>> sectionSets = {
+            {QStringLiteral("all"), allSections},
+            {QStringLiteral("enabled"), QOnlineTranslatorPrivateAccess::googleSections(translator)},
+        };
+        for (const auto &[sectionsName, sections] : sectionSets) {
+            QUrl url(googleUrl + "/translate_a/single");
+            url.setQuery(QStringLiteral("client=gtx&ie=UTF-8&oe=UTF-8&%1&sl=en&tl=ru&hl=en").arg(sections));
+            QNetworkRequest request(url);
+            request.setHeader(QNetworkRequest::ContentTypeHeader, "application/x-www-form-urlencoded");
+
+            QEventLoop loop;
+            QNetworkReply *reply = manager.post(request, "q=" + QUrl::toPercentEncoding(text));
+            QObject::connect(reply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
+            loop.exec();
+            reply->deleteLater();
+            if (reply->error() != QNetworkReply::NoError) {
+                out << textName << ' ' << sectionsName << ": " << reply->errorString() << '\n';
+                ++failures;
+                continue;
+            }
+            const QByteArray body = reply->readAll();
+
+            // Parse the same body repeatedly, the reply is created outside of the measurement
+            qint64 parseNsecs = 0;
+            QElapsedTimer timer;
+            for (int i = 0; i < parses; ++i) {
+                RecordedReply recordedReply(body);
+                timer.start();
+                QOnlineTranslatorPrivateAccess::parseReply(translator, QStringLiteral("google-translate"), &recordedReply);
+                parseNsecs += timer.nsecsElapsed();
+            }
+            if (translator.error() != QOnlineTranslator::NoError) {
+                out << textName << ' ' << sectionsName << ": " << translator.errorString() << '\n';
+                ++failures;
+                continue;
+            }
+
+            const qreal parseUsecs = static_cast<qreal>(parseNsecs) / 1000 / parses;
+            out << QStringLiteral("%1 %2 %3 %4\n")
+                       .arg(textName, -8)
+                       .arg(sectionsName, -8)
+                       .arg(body.size(), 8)
+                       .arg(parseUsecs, 10, 'f', 2);
+            results.append(QJsonObject{
+                {"bytesReceived", body.size()},
+                {"parseUsecs", parseUsecs},
+                {"sections", sections},
+                {"text", textName},
+                {"textSize", text.size()},
+            });
+        }
+    }
+
+    return failures == 0 ? 0 : 1;
+}
+
+bool writeResults(const QString &fileName, const QJsonArray &results)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        QTextStream(stderr) << "Unable to write " << file.fileName() << ": " << file.errorString() << '\n';
+        return false;
+    }
+    file.write(QJsonDocument(results).toJson());
+    return true;
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName(QStringLiteral("QOnlineTranslatorBenchmarks"));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("End-to-end throughput and latency benchmarks against a local engine stand-in"));
+    parser.addHelpOption();
+    const QCommandLineOption enginesOption(QStringLiteral("engines"), QStringLiteral("Comma-separated engines to benchmark."), QStringLiteral("engines"), QStringLiteral("Google,Yandex,Bing,LibreTranslate,Lingva"));
+    const QCommandLineOption profilesOption(QStringLiteral("profiles"), QStringLiteral("Comma-separated profiles: full (all data enabled) and plain (translation only)."), QStringLiteral("profiles"), QStringLiteral("full,plain"));
+    const QCommandLineOption concurrencyOption(QStringLiteral("concurrency"), QStringLiteral("Comma-separated numbers of parallel translators."), QStringLiteral("levels"), QStringLiteral("1,4,16,64"));
+    const QCommandLineOption sizesOption(QStringLiteral("sizes"), QStringLiteral("Comma-separated text sizes in characters."), QStringLiteral("sizes"), QStringLiteral("100,1000,10000"));
+    const QCommandLineOption requestsOption(QStringLiteral("requests"), QStringLiteral("Translations per configuration."), QStringLiteral("count"), QStringLiteral("200"));
+    const QCommandLineOption timeoutOption(QStringLiteral("timeout"), QStringLiteral("Time limit per configuration in milliseconds."), QStringLiteral("msecs"), QStringLiteral("60000"));
+    const QCommandLineOption latencyOption(QStringLiteral("latency"), QStringLiteral("Stand-in server delay per response in milliseconds."), QStringLiteral("msecs"), QStringLiteral("0"));
+    const QCommandLineOption errorRateOption(QStringLiteral("error-rate"), QStringLiteral("Stand-in server probability of answering with 503."), QStringLiteral("rate"), QStringLiteral("0"));
+    const QCommandLineOption replayOption(QStringLiteral("replay"), QStringLiteral("Directory with recorded responses to replay."), QStringLiteral("directory"));
+    const QCommandLineOption recordOption(QStringLiteral("record"), QStringLiteral("Record real engine responses to the directory and exit."), QStringLiteral("directory"));
+    const QCommandLineOption libreUrlOption(QStringLiteral("libre-url"), QStringLiteral("LibreTranslate instance to record from."), QStringLiteral("url"));
+    const QCommandLineOption lingvaUrlOption(QStringLiteral("lingva-url"), QStringLiteral("Lingva instance to record from."), QStringLiteral("url"));
+    const QCommandLineOption compareSectionsOption(QStringLiteral("compare-google-sections"), QStringLiteral("Request real Google responses with all and with enabled sections, report their size and parse time and exit."));
+    const QCommandLineOption googleUrlOption(QStringLiteral("google-url"), QStringLiteral("Google instance to compare the sections with."), QStringLiteral("url"), QStringLiteral("https://translate.googleapis.com"));
+    const QCommandLineOption parsesOption(QStringLiteral("parses"), QStringLiteral("Parses of every response to average the parse time."), QStringLiteral("count"), QStringLiteral("1000"));
+    const QCommandLineOption outputOption({QStringLiteral("o"), QStringLiteral("output")}, QStringLiteral("Write results as JSON to the file."), QStringLiteral("file"));
+    parser.addOptions({enginesOption, profilesOption, concurrencyOption, sizesOption, requestsOption, timeoutOption, latencyOption, errorRateOption, replayOption, recordOption, libreUrlOption, lingvaUrlOption, compareSectionsOption, googleUrlOption, parsesOption, outputOption});
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    QList<QOnlineTranslator::Engine> engines;
+    for (const QString &name : splitList(parser.value(enginesOption))) {
+        bool ok;
+        const int engine = QMetaEnum::fromType<QOnlineTranslator::Engine>().keyToValue(name.toLatin1(), &ok);
+        if (!ok) {
+            err << "Unknown engine: " << name << '\n';
+            return 1;
+        }
+        engines.append(static_cast<QOnlineTranslator::Engine>(engine));
+    }
+
+    if (parser.isSet(recordOption))
+        return record(parser.value(recordOption), engines, parser.value(libreUrlOption), parser.value(lingvaUrlOption));
+
+    if (parser.isSet(compareSectionsOption)) {
+        QJsonArray results;
+        const int exitCode = compareGoogleSections(parser.value(googleUrlOption), qMax(parser.value(parsesOption).toInt(), 1), results);
+        if (parser.isSet(outputOption) && !writeResults(parser.value(outputOption), results))
+            return 1;
+        return exitCode;
+    }
+
+    // Run the stand-in in a separate thread to not mix its work with the measured one
+    QThread serverThread;
+    QObject::connect(&serverThread, &QThread::started, [] {
+        t_countAllocations = false;
+    });
+    auto *server = new MockEngineServer;
+    server->setLatency(parser.value(latencyOption).toInt());
+    server->setErrorRate(parser.value(errorRateOption).toDouble());
+    if (parser.isSet(replayOption))
+        out << "Loaded recordings: " << server->loadRecordings(parser.value(replayOption)) << '\n';
+    server->moveToThread(&serverThread);
+    QObject::connect(&serverThread, &QThread::finished, server, &QObject::deleteLater);
+    serverThread.start();
+
+    bool listening = false;
+    QMetaObject::invokeMethod(server, [server, &listening] {
+        listening = server->start();
+    }, Qt::BlockingQueuedConnection);
+    if (!listening) {
+        err << "Unable to start stand-in server\n";
+        serverThread.quit();
+        serverThread.wait();
+        return 1;
+    }
+    const QString serverUrl = server->url();
+
+    const int requests = parser.value(requestsOption).toInt();
+    const int timeout = parser.value(timeoutOption).toInt();
+    QJsonArray results;
+    out << QStringLiteral("%1 %2 %3 %4 %5 %6 %7 %8 %9\n")
+               .arg(QStringLiteral("engine"), -15)
+               .arg(QStringLiteral("profile"), -8)
+               .arg(QStringLiteral("conc"), 5)
+               .arg(QStringLiteral("size"), 6)
+               .arg(QStringLiteral("req/s"), 9)
+               .arg(QStringLiteral("p50 ms"), 8)
+               .arg(QStringLiteral("p99 ms"), 8)
+               .arg(QStringLiteral("allocs"), 8)
+               .arg(QStringLiteral("bytes"), 8);
+    for (QOnlineTranslator::Engine engine : qAsConst(engines)) {
+        for (const QString &profile : splitList(parser.value(profilesOption))) {
+            for (int textSize : parseIntegers(parser.value(sizesOption))) {
+                for (int concurrency : parseIntegers(parser.value(concurrencyOption))) {
+                    const Configuration config{engine, profile, concurrency, textSize};
+                    const QJsonObject result = toJson(config, run(config, serverUrl, requests, timeout));
+                    const QJsonObject latency = result.value(QStringLiteral("latencyMs")).toObject();
+                    out << QStringLiteral("%1 %2 %3 %4 %5 %6 %7 %8 %9%10\n")
+                               .arg(engineName(engine), -15)
+                               .arg(profile, -8)
+                               .arg(concurrency, 5)
+                               .arg(textSize, 6)
+                               .arg(result.value(QStringLiteral("requestsPerSecond")).toDouble(), 9, 'f', 1)
+                               .arg(latency.value(QStringLiteral("p50")).toDouble(), 8, 'f', 2)
+                               .arg(latency.value(QStringLiteral("p99")).toDouble(), 8, 'f', 2)
+                               .arg(result.value(QStringLiteral("allocationsPerTranslation")).toDouble(), 8, 'f', 0)
+                               .arg(result.value(QStringLiteral("bytesReceivedPerTranslation")).toDouble(), 8, 'f', 0)
+                               .arg(result.value(QStringLiteral("errors")).toInt() > 0 ? QStringLiteral(" (%1 errors)").arg(result.value(QStringLiteral("errors")).toInt()) : QString());
+                    out.flush();
+                    results.append(result);
+                }
+            }
+        }
+    }
+
+    serverThread.quit();
+    serverThread.wait();
+
+    if (parser.isSet(outputOption) && !writeResults(parser.value(outputOption), results))
+        return 1;
+
+    return 0;
+}
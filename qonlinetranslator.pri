@@ -3,12 +3,31 @@ QT += network multimedia
 HEADERS += $$PWD/src/qonlinetranslator.h \
     $$PWD/src/qonlinetts.h \
     $$PWD/src/qexample.h \
-    $$PWD/src/qoption.h
+    $$PWD/src/qoption.h \
+    $$PWD/src/qdictionarycache.h \
+    $$PWD/src/qlanguagedetector.h \
+    $$PWD/src/qlatencyhistogram.h \
+    $$PWD/src/qpercentencoder.h \
+    $$PWD/src/qscripthistogram.h \
+    $$PWD/src/qtranslationmetrics.h \
+    $$PWD/src/qtranslationresult.h \
+    $$PWD/src/qtranslationtimings.h \
+    $$PWD/src/qtranslationtracer.h \
+    $$PWD/src/qtransliterator.h
 
 SOURCES += $$PWD/src/qonlinetranslator.cpp \
     $$PWD/src/qonlinetts.cpp \
     $$PWD/src/qexample.cpp \
-    $$PWD/src/qoption.cpp
+    $$PWD/src/qoption.cpp \
+    $$PWD/src/qdictionarycache.cpp \
+    $$PWD/src/qlanguagedetector.cpp \
+    $$PWD/src/qlatencyhistogram.cpp \
+    $$PWD/src/qpercentencoder.cpp \
+    $$PWD/src/qscripthistogram.cpp \
+    $$PWD/src/qtranslationmetrics.cpp \
+    $$PWD/src/qtranslationresult.cpp \
+    $$PWD/src/qtranslationtimings.cpp \
+    $$PWD/src/qtransliterator.cpp
 
 INCLUDEPATH += $$PWD/src
 
@@ -0,0 +1,237 @@
+/*
+ *  Copyright © 2018-2023 Hennadii Chernyshchyk <genaloner@gmail.com>
+ *
+ *  This file is part of QOnlineTranslator.
+ *
+ *  QOnlineTranslator is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  QOnlineTranslator is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with QOnlineTranslator. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "qdictionarycache.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QMetaEnum>
+#include <QSaveFile>
+
+std::optional<QDictionaryCache::Entry> QDictionaryCache::find(QOnlineTranslator::Engine engine, QOnlineTranslator::Language sourceLang, QOnlineTranslator::Language translationLang, QOnlineTranslator::Language uiLang, const QString &word)
+{
+    QMutexLocker locker(&m_mutex);
+    const auto it = m_items.find({engine, sourceLang, translationLang, uiLang, word});
+    if (it == m_items.end())
+        return std::nullopt;
+
+    if (it->expiration <= QDateTime::currentMSecsSinceEpoch()) {
+        remove(it);
+        return std::nullopt;
+    }
+
+    return it->entry;
+}
+
+void QDictionaryCache::insert(QOnlineTranslator::Engine engine, QOnlineTranslator::Language sourceLang, QOnlineTranslator::Language translationLang, QOnlineTranslator::Language uiLang, const QString &word, const Entry &entry)
+{
+    QMutexLocker locker(&m_mutex);
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    const Key key{engine, sourceLang, translationLang, uiLang, word};
+    const auto it = m_items.find(key);
+    if (it != m_items.end())
+        remove(it);
+
+    if (m_maxSize <= 0)
+        return;
+
+    while (m_items.size() >= m_maxSize)
+        removeOldest();
+    m_items.insert(key, {entry, now + m_ttl * 1000, m_order.insert(m_order.end(), key)});
+}
+
+void QDictionaryCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_items.clear();
+    m_order.clear();
+}
+
+int QDictionaryCache::size() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_items.size();
+}
+
+qint64 QDictionaryCache::ttl() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_ttl;
+}
+
+void QDictionaryCache::setTtl(qint64 seconds)
+{
+    QMutexLocker locker(&m_mutex);
+    m_ttl = seconds;
+}
+
+int QDictionaryCache::maxSize() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_maxSize;
+}
+
+void QDictionaryCache::setMaxSize(int size)
+{
+    QMutexLocker locker(&m_mutex);
+    m_maxSize = size;
+    while (!m_order.empty() && m_items.size() > m_maxSize)
+        removeOldest();
+}
+
+bool QDictionaryCache::save(const QString &fileName) const
+{
+    const QMetaEnum engines = QMetaEnum::fromType<QOnlineTranslator::Engine>();
+    const QMetaEnum languages = QMetaEnum::fromType<QOnlineTranslator::Language>();
+
+    QJsonArray entries;
+    {
+        QMutexLocker locker(&m_mutex);
+        const qint64 now = QDateTime::currentMSecsSinceEpoch();
+        for (const Key &key : m_order) {
+            const Item &item = *m_items.constFind(key);
+            if (item.expiration <= now)
+                continue;
+
+            QJsonObject translationOptions;
+            for (auto optionsIt = item.entry.translationOptions.cbegin(); optionsIt != item.entry.translationOptions.cend(); ++optionsIt) {
+                QJsonArray arr;
+                for (const QOption &option : optionsIt.value())
+                    arr.append(option.toJson());
+                translationOptions.insert(optionsIt.key(), arr);
+            }
+
+            QJsonObject examples;
+            for (auto examplesIt = item.entry.examples.cbegin(); examplesIt != item.entry.examples.cend(); ++examplesIt) {
+                QJsonArray arr;
+                for (const QExample &example : examplesIt.value())
+                    arr.append(example.toJson());
+                examples.insert(examplesIt.key(), arr);
+            }
+
+            entries.append(QJsonObject{
+                {"engine", engines.valueToKey(key.engine)},
+                {"sourceLanguage", languages.valueToKey(key.sourceLang)},
+                {"translationLanguage", languages.valueToKey(key.translationLang)},
+                {"uiLanguage", languages.valueToKey(key.uiLang)},
+                {"word", key.word},
+                {"expiration", static_cast<double>(item.expiration)},
+                {"translationOptions", qMove(translationOptions)},
+                {"examples", qMove(examples)},
+                {"transcription", item.entry.transcription},
+            });
+        }
+    }
+
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    file.write(QJsonDocument(QJsonObject{{"entries", entries}}).toJson(QJsonDocument::Compact));
+    return file.commit();
+}
+
+bool QDictionaryCache::load(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QJsonParseError error;
+    const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &error);
+    if (error.error != QJsonParseError::NoError)
+        return false;
+
+    const QMetaEnum engines = QMetaEnum::fromType<QOnlineTranslator::Engine>();
+    const QMetaEnum languages = QMetaEnum::fromType<QOnlineTranslator::Language>();
+    const QJsonArray entries = document.object().value(QStringLiteral("entries")).toArray();
+
+    QMutexLocker locker(&m_mutex);
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    for (const QJsonValue &entryData : entries) {
+        const QJsonObject entryObject = entryData.toObject();
+        const auto expiration = static_cast<qint64>(entryObject.value(QStringLiteral("expiration")).toDouble());
+        if (expiration <= now)
+            continue;
+
+        // Enums are stored by names to not depend on their values
+        bool engineOk;
+        bool sourceLangOk;
+        bool translationLangOk;
+        bool uiLangOk;
+        const Key key{
+            static_cast<QOnlineTranslator::Engine>(engines.keyToValue(entryObject.value(QStringLiteral("engine")).toString().toLatin1().constData(), &engineOk)),
+            static_cast<QOnlineTranslator::Language>(languages.keyToValue(entryObject.value(QStringLiteral("sourceLanguage")).toString().toLatin1().constData(), &sourceLangOk)),
+            static_cast<QOnlineTranslator::Language>(languages.keyToValue(entryObject.value(QStringLiteral("translationLanguage")).toString().toLatin1().constData(), &translationLangOk)),
+            static_cast<QOnlineTranslator::Language>(languages.keyToValue(entryObject.value(QStringLiteral("uiLanguage")).toString().toLatin1().constData(), &uiLangOk)),
+            entryObject.value(QStringLiteral("word")).toString(),
+        };
+        if (!engineOk || !sourceLangOk || !translationLangOk || !uiLangOk)
+            continue;
+
+        Entry entry;
+        const QJsonObject translationOptions = entryObject.value(QStringLiteral("translationOptions")).toObject();
+        for (auto it = translationOptions.constBegin(); it != translationOptions.constEnd(); ++it) {
+            const QJsonArray optionsData = it.value().toArray();
+            QVector<QOption> &options = entry.translationOptions[it.key()];
+            options.reserve(optionsData.size());
+            for (const QJsonValue &option : optionsData)
+                options.append(QOption::fromJson(option.toObject()));
+        }
+
+        const QJsonObject examples = entryObject.value(QStringLiteral("examples")).toObject();
+        for (auto it = examples.constBegin(); it != examples.constEnd(); ++it) {
+            const QJsonArray examplesData = it.value().toArray();
+            QVector<QExample> &typeExamples = entry.examples[it.key()];
+            typeExamples.reserve(examplesData.size());
+            for (const QJsonValue &example : examplesData)
+                typeExamples.append(QExample::fromJson(example.toObject()));
+        }
+
+        entry.transcription = entryObject.value(QStringLiteral("transcription")).toString();
+
+        const auto it = m_items.find(key);
+        if (it != m_items.end())
+            remove(it);
+        else if (m_items.size() >= m_maxSize)
+            break;
+        m_items.insert(key, {entry, expiration, m_order.insert(m_order.end(), key)});
+    }
+
+    return true;
+}
+
+void QDictionaryCache::remove(QHash<Key, Item>::iterator it)
+{
+    m_order.erase(it->position);
+    m_items.erase(it);
+}
+
+void QDictionaryCache::removeOldest()
+{
+    m_items.remove(m_order.front());
+    m_order.pop_front();
+}
+
+bool QDictionaryCache::Key::operator==(const Key &other) const
+{
+    return engine == other.engine && sourceLang == other.sourceLang && translationLang == other.translationLang && uiLang == other.uiLang && word == other.word;
+}
@@ -0,0 +1,213 @@
+/*
+ *  Copyright © 2018-2023 Hennadii Chernyshchyk <genaloner@gmail.com>
+ *
+ *  This file is part of QOnlineTranslator.
+ *
+ *  QOnlineTranslator is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  QOnlineTranslator is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with QOnlineTranslator. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef QDICTIONARYCACHE_H
+#define QDICTIONARYCACHE_H
+
+#include "qexample.h"
+#include "qonlinetranslator.h"
+#include "qoption.h"
+
+#include <QHash>
+#include <QMutex>
+
+#include <list>
+#include <optional>
+
+/**
+ * @brief Stores translation options and examples of single words
+ *
+ * Dictionaries are requested by Yandex and Bing with an additional request after the translation.
+ * Words are repeated often, so the parsed dictionaries can be reused by setting the cache with QOnlineTranslator::setDictionaryCache().
+ * Entries expire after the specified time, the oldest entries are removed when the size limit is reached.
+ * The cache can be saved to a file to be reused after restart.
+ * Lookups are recorded in QTranslationMetrics.
+ *
+ * Example:
+ * @code
+ * QDictionaryCache cache;
+ * cache.load(cacheFileName);
+ *
+ * QOnlineTranslator translator;
+ * translator.setDictionaryCache(&cache);
+ * // Obtain translations
+ *
+ * cache.save(cacheFileName);
+ * @endcode
+ *
+ * All methods are thread-safe, so the same cache can be used by translators in different threads.
+ */
+class QDictionaryCache
+{
+    Q_DISABLE_COPY(QDictionaryCache)
+
+public:
+    /**
+     * @brief Cached dictionary of a word
+     */
+    struct Entry {
+        /**
+         * @brief Translation options by the type of speech
+         */
+        QMap<QString, QVector<QOption>> translationOptions;
+
+        /**
+         * @brief Examples by the type of speech
+         */
+        QMap<QString, QVector<QExample>> examples;
+
+        /**
+         * @brief Transcription of the word, if provided by the engine
+         */
+        QString transcription;
+    };
+
+    /**
+     * @brief Create empty cache
+     */
+    QDictionaryCache() = default;
+
+    /**
+     * @brief Find dictionary of the word
+     *
+     * @param engine engine that provided the dictionary
+     * @param sourceLang language of the word
+     * @param translationLang language of the translation
+     * @param uiLang language of the descriptions
+     * @param word word
+     * @return dictionary or `std::nullopt` if not found or expired
+     */
+    std::optional<Entry> find(QOnlineTranslator::Engine engine, QOnlineTranslator::Language sourceLang, QOnlineTranslator::Language translationLang, QOnlineTranslator::Language uiLang, const QString &word);
+
+    /**
+     * @brief Add dictionary of the word
+     *
+     * Replaces the existing dictionary of the word.
+     *
+     * @param engine engine that provided the dictionary
+     * @param sourceLang language of the word
+     * @param translationLang language of the translation
+     * @param uiLang language of the descriptions
+     * @param word word
+     * @param entry dictionary
+     */
+    void insert(QOnlineTranslator::Engine engine, QOnlineTranslator::Language sourceLang, QOnlineTranslator::Language translationLang, QOnlineTranslator::Language uiLang, const QString &word, const Entry &entry);
+
+    /**
+     * @brief Remove all entries
+     */
+    void clear();
+
+    /**
+     * @brief Number of entries
+     *
+     * @return number of entries, including expired ones that were not removed yet
+     */
+    int size() const;
+
+    /**
+     * @brief Time to live of entries
+     *
+     * @return time in seconds after which an entry is expired
+     */
+    qint64 ttl() const;
+
+    /**
+     * @brief Set time to live of entries
+     *
+     * Applies to the new entries, default is 30 days.
+     *
+     * @param seconds time after which an entry is expired
+     */
+    void setTtl(qint64 seconds);
+
+    /**
+     * @brief Maximum number of entries
+     *
+     * @return maximum number of entries
+     */
+    int maxSize() const;
+
+    /**
+     * @brief Set maximum number of entries
+     *
+     * Default is 10000. If the limit is reached, the earliest inserted entries are removed on insertion.
+     *
+     * @param size maximum number of entries
+     */
+    void setMaxSize(int size);
+
+    /**
+     * @brief Save entries to the file
+     *
+     * Expired entries are not saved.
+     *
+     * @param fileName path to the file
+     * @return `true` on success
+     */
+    bool save(const QString &fileName) const;
+
+    /**
+     * @brief Load entries from the file
+     *
+     * Loaded entries are added to the existing ones, expired entries are skipped.
+     *
+     * @param fileName path to the file created by save()
+     * @return `true` on success
+     */
+    bool load(const QString &fileName);
+
+private:
+    struct Key {
+        QOnlineTranslator::Engine engine;
+        QOnlineTranslator::Language sourceLang;
+        QOnlineTranslator::Language translationLang;
+        QOnlineTranslator::Language uiLang;
+        QString word;
+
+        bool operator==(const Key &other) const;
+
+        friend uint qHash(const Key &key, uint seed)
+        {
+            // Languages and engines fit into a byte
+            const uint enums = static_cast<uint>(key.engine) << 24 ^ static_cast<uint>(key.sourceLang) << 16 ^ static_cast<uint>(key.translationLang) << 8 ^ static_cast<uint>(key.uiLang);
+            return qHash(key.word, seed) ^ enums;
+        }
+    };
+
+    struct Item {
+        Entry entry;
+        qint64 expiration; // In milliseconds since epoch
+        std::list<Key>::iterator position; // In the insertion order
+    };
+
+    void remove(QHash<Key, Item>::iterator it);
+    void removeOldest();
+
+    static constexpr qint64 s_defaultTtl = 30 * 24 * 60 * 60;
+    static constexpr int s_defaultMaxSize = 10000;
+
+    mutable QMutex m_mutex;
+    QHash<Key, Item> m_items;
+    std::list<Key> m_order; // Keys from the earliest inserted
+    qint64 m_ttl = s_defaultTtl;
+    int m_maxSize = s_defaultMaxSize;
+};
+
+#endif // QDICTIONARYCACHE_H
@@ -30,3 +30,8 @@ QJsonObject QExample::toJson() const
 
     return object;
 }
+
+QExample QExample::fromJson(const QJsonObject &object)
+{
+    return {object.value(QStringLiteral("example")).toString(), object.value(QStringLiteral("description")).toString()};
+}
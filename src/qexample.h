@@ -76,6 +76,14 @@ struct QExample {
      * @return JSON representation
      */
     QJsonObject toJson() const;
+
+    /**
+     * @brief Creates the object from JSON
+     *
+     * @param object JSON representation created by toJson()
+     * @return example
+     */
+    static QExample fromJson(const QJsonObject &object);
 };
 
 #endif // QEXAMPLE_H
@@ -0,0 +1,336 @@
+/*
+ *  Copyright © 2018-2023 Hennadii Chernyshchyk <genaloner@gmail.com>
+ *
+ *  This file is part of QOnlineTranslator.
+ *
+ *  QOnlineTranslator is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  QOnlineTranslator is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with QOnlineTranslator. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "qlanguagedetector.h"
+
+#include <algorithm>
+#include <array>
+#include <iterator>
+
+// Languages that are the only users of the script, indexed by script
+constexpr QOnlineTranslator::Language QLanguageDetector::s_scriptLanguages[] = {
+    QOnlineTranslator::NoLanguage, // Latin
+    QOnlineTranslator::NoLanguage, // Cyrillic
+    QOnlineTranslator::Greek,
+    QOnlineTranslator::Armenian,
+    QOnlineTranslator::Georgian,
+    QOnlineTranslator::NoLanguage, // Hebrew
+    QOnlineTranslator::NoLanguage, // Arabic
+    QOnlineTranslator::NoLanguage, // Devanagari
+    QOnlineTranslator::Bengali,
+    QOnlineTranslator::Punjabi,
+    QOnlineTranslator::Gujarati,
+    QOnlineTranslator::Oriya,
+    QOnlineTranslator::Tamil,
+    QOnlineTranslator::Telugu,
+    QOnlineTranslator::Kannada,
+    QOnlineTranslator::Malayalam,
+    QOnlineTranslator::Sinhala,
+    QOnlineTranslator::Thai,
+    QOnlineTranslator::Lao,
+    QOnlineTranslator::Myanmar,
+    QOnlineTranslator::Amharic,
+    QOnlineTranslator::Khmer,
+    QOnlineTranslator::Korean,
+    QOnlineTranslator::Japanese,
+    QOnlineTranslator::NoLanguage, // Han
+};
+
+constexpr QLanguageDetector::Profile QLanguageDetector::s_profiles[] = {
+    // Latin
+    {QOnlineTranslator::Afrikaans, LatinScript, u"die en is van in het nie dat wat om te op vir met sy ek jy hulle ons", u"êëôûŉ"},
+    {QOnlineTranslator::Albanian, LatinScript, u"dhe të në një për është me që nga nuk si ka do", u"ëç"},
+    {QOnlineTranslator::Azerbaijani, LatinScript, u"və bir bu da ki üçün ilə çox amma daha kimi olaraq var deyil mən", u"əğış"},
+    {QOnlineTranslator::Basque, LatinScript, u"eta da ez bat du dira baina ere zen hau honen edo dut", u""},
+    {QOnlineTranslator::Catalan, LatinScript, u"el la i de que en els les un una per és amb no del al als com", u"çàèéíòóúï·"},
+    {QOnlineTranslator::Cebuano, LatinScript, u"ang sa nga ug mga si kay dili ni kini siya ako", u""},
+    {QOnlineTranslator::Croatian, LatinScript, u"i je u se na da za su ne od to što kao ali sam bi iz", u"čćđšž"},
+    {QOnlineTranslator::Czech, LatinScript, u"a je se na v že to s o z do jsem jak ale by jsou není také který co tak už jen velmi byl byla bude může mě ten ta tento jsme jste nebo když", u"ěščřžůťďň"},
+    {QOnlineTranslator::Danish, LatinScript, u"og at det i en som er på for med af den ikke til jeg har de noget meget blev os mig dig hende ham jer hvad hvor nu lidt også bliver kan skal vil fra", u"æøå"},
+    {QOnlineTranslator::Dutch, LatinScript, u"de het een en van is dat niet op te zijn voor met die ik je zo hij er maar ook wat hoe als dan nog al veel was heeft hebben wordt kan we jullie mijn hun zij ons bij naar uit om", u"ĳ"},
+    {QOnlineTranslator::English, LatinScript, u"the and of to in is that it for you was with on are this be have not at as but they his from i he she we what there their which will would can if or an by all one so do no about out up my your", u""},
+    {QOnlineTranslator::Esperanto, LatinScript, u"la de kaj en estas al ke por ne mi kun ĝi li", u"ĉĝĥĵŝŭ"},
+    {QOnlineTranslator::Estonian, LatinScript, u"ja on ei et see ta oli kui aga ka mis ma nii või", u"õäöüšž"},
+    {QOnlineTranslator::Finnish, LatinScript, u"ja on ei se että hän oli ovat mutta kun niin tämä myös ole", u"äö"},
+    {QOnlineTranslator::French, LatinScript, u"le la les et des est un une du que pas pour dans en qui sur au il elle je nous vous ce avec ne se sa son ses mais ou où donc très tout cette ces été être avoir fait comme plus on lui leur y aux par", u"éèêàçùœâîô"},
+    {QOnlineTranslator::Frisian, LatinScript, u"de it in en fan is dat net op te foar mei hy sy", u"âêûú"},
+    {QOnlineTranslator::Galician, LatinScript, u"o a os as de que e do da en un unha para con non é se no na por máis", u"áéíóúñ"},
+    {QOnlineTranslator::German, LatinScript, u"der die das und ist nicht ein eine zu den von mit sich des auf dem ich sie es im auch wir wie aber oder wenn dann noch nur schon sehr war hat haben sind wird werden kann einen einem einer über uns ihr mein dein sein was wer", u"äöüß"},
+    {QOnlineTranslator::HaitianCreole, LatinScript, u"ak nan pou li se yo ki mwen pa sa ou te", u"èò"},
+    {QOnlineTranslator::Hausa, LatinScript, u"da a na ya ta su ba ne ce wannan", u"ɓɗƙ"},
+    {QOnlineTranslator::Hawaiian, LatinScript, u"ka ke o i ma me ʻo ua he", u"ʻāēīōū"},
+    {QOnlineTranslator::Hungarian, LatinScript, u"a az és hogy nem is egy van meg de el ez csak mint már volt ki én te ő mi ti ők igen nagyon minden ezt azt lesz vagy mert amikor hol", u"őűáéíóöüú"},
+    {QOnlineTranslator::Icelandic, LatinScript, u"og að er í á sem til ekki með það við hann um en var", u"ðþæöáéíóúý"},
+    {QOnlineTranslator::Igbo, LatinScript, u"na ya ka o bụ nke ha", u"ịọụ"},
+    {QOnlineTranslator::Indonesian, LatinScript, u"yang dan di ke dari ini itu dengan untuk tidak ada dalam akan pada juga saya bisa karena saja", u""},
+    {QOnlineTranslator::Irish, LatinScript, u"agus an na is ar a le go ní sé sí bhí ag seo", u"áéíóú"},
+    {QOnlineTranslator::Italian, LatinScript, u"il la di che e è un una per non in del della sono con si lo gli le ma questo anche io tu lui lei noi voi loro sì molto tutto questa quello già quando dove perché senza tra fino da essere era ha fa mi ti ci suo sua nel nella alla al dei delle come più", u"àèéìòù"},
+    {QOnlineTranslator::Javanese, LatinScript, u"lan ing kang iku ora karo wis", u""},
+    {QOnlineTranslator::Kurdish, LatinScript, u"û di de ji li ku ew bi ya", u"êîûşç"},
+    {QOnlineTranslator::Latin, LatinScript, u"et in est non ad cum quod ut sed qui quae esse sunt", u""},
+    {QOnlineTranslator::Latvian, LatinScript, u"un ir ar uz ka no par tas kā bet arī vai es viņš", u"āčēģīķļņšūž"},
+    {QOnlineTranslator::Lithuanian, LatinScript, u"ir yra kad su į ne o tai bet iš kaip jis buvo per", u"ąčęėįšųūž"},
+    {QOnlineTranslator::Luxembourgish, LatinScript, u"an den der ass net e mat fir dat et och ze", u"ëéä"},
+    {QOnlineTranslator::Malagasy, LatinScript, u"ny sy ary dia tsy izy fa amin", u""},
+    {QOnlineTranslator::Malay, LatinScript, u"yang dan di ke dari ini itu dengan untuk tidak ada dalam akan pada juga saya boleh kerana sahaja", u""},
+    {QOnlineTranslator::Maltese, LatinScript, u"il u ta li fil huwa ma għal minn dan din kien", u"ċġħż"},
+    {QOnlineTranslator::Maori, LatinScript, u"te ki he ko i me ngā", u"āēīōū"},
+    {QOnlineTranslator::Norwegian, LatinScript, u"og at det i en som er på for med av den ikke til jeg har de noe mye ble oss meg deg henne ham dere hva hvor nå litt også blir kan skal vil fra", u"æøå"},
+    {QOnlineTranslator::Polish, LatinScript, u"i w nie na się z że to do jest jak o co ale po tak od dla czy już tylko bardzo jestem był była są będzie może mnie ten ta te który która przez przy", u"ąćęłńśźż"},
+    {QOnlineTranslator::Portuguese, LatinScript, u"o a os as de que e do da em um uma para com não é se no na por mais dos das eu você ele ela nós sim muito também há tudo esta este isso já quando onde porque sem sobre entre até desde ser foi são tem faz minha meu seu sua nos ao pelo pela como mas", u"ãõçáâêôà"},
+    {QOnlineTranslator::Romanian, LatinScript, u"și în de la a cu nu este o să pe că care un din mai eu tu el ea noi voi ei da foarte tot această acest fost sunt au ce când unde pentru dar sau", u"ăâîșțşţ"},
+    {QOnlineTranslator::Samoan, LatinScript, u"ma le o i ua e lea", u""},
+    {QOnlineTranslator::ScotsGaelic, LatinScript, u"agus an na is air a le gu chan e i bha aig seo", u"àèìòù"},
+    {QOnlineTranslator::SerbianLatin, LatinScript, u"i je u se na da za su ne od to šta kao ali sam bi iz", u"čćđšž"},
+    {QOnlineTranslator::Sesotho, LatinScript, u"le ho ka ya ba e sa", u""},
+    {QOnlineTranslator::Shona, LatinScript, u"uye ne kuti iye asi", u""},
+    {QOnlineTranslator::Slovak, LatinScript, u"a je sa na v že to s o z do som ako ale by sú nie aj ktorý čo tak už len veľmi bol bola bude môže ma ten ta tento sme ste alebo keď", u"ôäľĺŕščž"},
+    {QOnlineTranslator::Slovenian, LatinScript, u"in je na se da v za so ne z pa tudi ki to kot bi sem", u"čšž"},
+    {QOnlineTranslator::Somali, LatinScript, u"iyo waa in ka u oo ah ee ku uu ay wax", u""},
+    {QOnlineTranslator::Spanish, LatinScript, u"el la los las de que y en un una es por con para no se del al lo como pero más está yo tú él ella nosotros sí muy también hay todo esta este eso ya cuando donde porque sin sobre entre hasta desde ser fue son tiene hace esa mi me te le les nos su sus", u"ñ¿¡áéíóú"},
+    {QOnlineTranslator::Sundanese, LatinScript, u"jeung di nu teu ka ieu éta", u""},
+    {QOnlineTranslator::Swahili, LatinScript, u"na ya wa kwa ni za katika la kuwa hii yake huo lakini pia", u""},
+    {QOnlineTranslator::Swedish, LatinScript, u"och att det i en som är på för med av den inte till jag har om vi ni hon han vad var nu lite också blir kan ska vill från mig dig henne honom oss er", u"åäö"},
+    {QOnlineTranslator::Tagalog, LatinScript, u"ang ng sa na mga at ay si ito hindi ko ako siya niya", u""},
+    {QOnlineTranslator::Turkish, LatinScript, u"ve bir bu da de için ile ne çok ama daha gibi olarak var değil ben şu o sen biz siz onlar mı mi evet hayır en kadar sonra önce şey yok", u"ğışçöü"},
+    {QOnlineTranslator::Turkmen, LatinScript, u"we bu bilen üçin bir hem", u"äçňöşüýž"},
+    {QOnlineTranslator::Uzbek, LatinScript, u"va bu bilan uchun bir ham emas edi", u"ʻ"},
+    {QOnlineTranslator::Vietnamese, LatinScript, u"và của là có không một những được cho trong với người này các đã", u"ăđơưạảếềệịọộờợụủứừự"},
+    {QOnlineTranslator::Welsh, LatinScript, u"y yr a ac i yn o ar mae ei ni ddim gyda fel ond", u"ŵŷ"},
+    {QOnlineTranslator::Xhosa, LatinScript, u"kwaye ukuba ngoko kodwa xa", u""},
+    {QOnlineTranslator::Yoruba, LatinScript, u"ni ti ati o si won fun pe je mo", u"ẹọṣ"},
+    {QOnlineTranslator::Zulu, LatinScript, u"na ukuthi futhi kodwa ngoba uma", u""},
+
+    // Cyrillic
+    {QOnlineTranslator::Bashkir, CyrillicScript, u"һәм был менән өсөн бер ҙә тип юҡ ул", u"әөүғҡңҙҫһ"},
+    {QOnlineTranslator::Belarusian, CyrillicScript, u"і ў не на што я з ён як гэта па але да у так за ад усё", u"ўі"},
+    {QOnlineTranslator::Bulgarian, CyrillicScript, u"и в не на че да се с той как това по но за от е към", u"ъ"},
+    {QOnlineTranslator::HillMari, CyrillicScript, u"да ма мӹнь тӹдӹ", u"ӓӧӱӹ"},
+    {QOnlineTranslator::Kazakh, CyrillicScript, u"және бұл мен үшін бір да деп не ол", u"әғқңөұүһі"},
+    {QOnlineTranslator::Kyrgyz, CyrillicScript, u"жана бул мен үчүн бир да деп эмес ал", u"ңөү"},
+    {QOnlineTranslator::Macedonian, CyrillicScript, u"и во не на што да се со тој како ова по но за од е", u"ѓќѕјљњџ"},
+    {QOnlineTranslator::Mari, CyrillicScript, u"да ден гына тиде мый тудо", u"ӓӧӱҥ"},
+    {QOnlineTranslator::Mongolian, CyrillicScript, u"нь бол энэ ба юм байна гэж би", u"өү"},
+    {QOnlineTranslator::Russian, CyrillicScript, u"и в не на что я с он как это по но к из у же так за от все мы вы они она оно бы был была были есть нет да только уже очень когда где почему меня тебя его её их этот эта мне", u"ыэъё"},
+    {QOnlineTranslator::SerbianCyrillic, CyrillicScript, u"и у је да се на за су не од што као али", u"ђјљњћџ"},
+    {QOnlineTranslator::Tajik, CyrillicScript, u"ва дар ба аз ки бо ин як барои", u"ғӣқӯҳҷ"},
+    {QOnlineTranslator::Tatar, CyrillicScript, u"һәм бу белән өчен бер да дип юк ул", u"әөүҗңһ"},
+    {QOnlineTranslator::Udmurt, CyrillicScript, u"но мон со та бен уг", u"ӝӟӥӧӵ"},
+    {QOnlineTranslator::Ukrainian, CyrillicScript, u"і в не на що я з він як це та але до у так за від все ми ви вони вона воно б був була були є ні тільки вже дуже коли де чому мене тебе його її їх цей ця мені чи", u"іїєґ"},
+
+    // Hebrew
+    {QOnlineTranslator::Hebrew, HebrewScript, u"של את הוא זה על לא עם כי אני גם היא", u""},
+    {QOnlineTranslator::Yiddish, HebrewScript, u"און איז דער די פון ניט מיט צו", u"װױײַָ"},
+
+    // Arabic
+    {QOnlineTranslator::Arabic, ArabicScript, u"في من على أن إلى هذا التي الذي عن مع كان ما لا هو", u"ةىأإ"},
+    {QOnlineTranslator::Pashto, ArabicScript, u"د په او چې له دا یې هم", u"ټډړږښګڼۍې"},
+    {QOnlineTranslator::Persian, ArabicScript, u"و در به از که این را با است برای آن یک می", u"پچژگکی"},
+    {QOnlineTranslator::Sindhi, ArabicScript, u"جي ۾ ۽ کي آهي ته هن", u"ڄڃڇڏڊڌڙڦڻ"},
+    {QOnlineTranslator::Uighur, ArabicScript, u"بىر بۇ ۋە ئۈچۈن بىلەن", u"ېۆۇۈۋئە"},
+    {QOnlineTranslator::Urdu, ArabicScript, u"کے میں کی ہے اور سے کو کا نہیں یہ", u"ٹڈڑںےہ"},
+
+    // Devanagari
+    {QOnlineTranslator::Hindi, DevanagariScript, u"है और के में की से का को यह हैं मैं तुम आप वह हम नहीं कि था थी थे होता किया कर लिए भी तो ही पर एक या कुछ", u""},
+    {QOnlineTranslator::Marathi, DevanagariScript, u"आहे आणि या हे ला आहेत होते मी तू तुम्ही तो ती आम्ही नाही की होता होती साठी पण तर एक किंवा काही", u"ळ"},
+    {QOnlineTranslator::Nepali, DevanagariScript, u"छ र को मा हो छन् थियो म तिमी तपाईं उनी हामी छैन कि भएको गरेको लागि पनि त नै एक वा केही हुन्छ", u""},
+
+    // Han
+    {QOnlineTranslator::Cantonese, HanScript, u"", u"嘅喺咗唔佢冇啲嚟咁"},
+    {QOnlineTranslator::SimplifiedChinese, HanScript, u"", u"这们个说国时会来对为学后过还发经长开关问与从见东车书买头"},
+    {QOnlineTranslator::TraditionalChinese, HanScript, u"", u"這們個說國時會來對為學後過還發經長開關問與從見東車書買頭"},
+};
+
+QLanguageDetector::Result QLanguageDetector::detect(const QString &text)
+{
+    static_assert(std::size(s_scriptLanguages) == ScriptsCount, "Language should be specified for all scripts");
+
+    const int length = qMin(text.size(), s_textLimit);
+
+    // Find the prevailing script
+    std::array<int, ScriptsCount> scriptCounts{};
+    int lettersCount = 0;
+    for (int i = 0; i < length; ++i) {
+        const QChar character = text.at(i);
+        if (!character.isLetter() && !character.isMark())
+            continue;
+
+        ++lettersCount;
+        const Script characterScript = script(character.unicode());
+        if (characterScript != OtherScript)
+            ++scriptCounts[characterScript];
+    }
+
+    // Japanese text mixes kana with Han characters
+    if (scriptCounts[KanaScript] != 0 && scriptCounts[KanaScript] >= s_kanaRatio * (scriptCounts[KanaScript] + scriptCounts[HanScript])) {
+        scriptCounts[KanaScript] += scriptCounts[HanScript];
+        scriptCounts[HanScript] = 0;
+    }
+
+    const auto prevailingCount = std::max_element(scriptCounts.cbegin(), scriptCounts.cend());
+    if (*prevailingCount == 0)
+        return {};
+
+    const auto textScript = static_cast<Script>(prevailingCount - scriptCounts.cbegin());
+    const qreal scriptRatio = static_cast<qreal>(*prevailingCount) / lettersCount;
+    if (s_scriptLanguages[textScript] != QOnlineTranslator::NoLanguage)
+        return {s_scriptLanguages[textScript], scriptRatio};
+
+    // Score languages that share the script
+    const Index &profilesIndex = index();
+    std::array<qreal, std::size(s_profiles)> scores{};
+    QString word;
+    auto scoreWord = [&] {
+        const auto profiles = profilesIndex.words.constFind(word);
+        if (profiles != profilesIndex.words.cend()) {
+            for (int profile : *profiles)
+                scores[profile] += 1.0 / profiles->size();
+        }
+        word.resize(0); // Keeps the capacity
+    };
+    for (int i = 0; i < length; ++i) {
+        const QChar character = text.at(i).toLower();
+        if (!character.isLetter() && !character.isMark()) {
+            if (!word.isEmpty())
+                scoreWord();
+            continue;
+        }
+
+        word += character;
+        const auto profiles = profilesIndex.letters.constFind(character.unicode());
+        if (profiles != profilesIndex.letters.cend()) {
+            for (int profile : *profiles)
+                scores[profile] += s_letterWeight / profiles->size();
+        }
+    }
+    if (!word.isEmpty())
+        scoreWord();
+
+    size_t bestProfile = std::size(s_profiles);
+    qreal bestScore = 0;
+    qreal secondScore = 0;
+    for (size_t i = 0; i < std::size(s_profiles); ++i) {
+        if (s_profiles[i].script != textScript)
+            continue;
+
+        if (scores[i] > bestScore) {
+            secondScore = bestScore;
+            bestScore = scores[i];
+            bestProfile = i;
+        } else if (scores[i] > secondScore) {
+            secondScore = scores[i];
+        }
+    }
+    if (bestProfile == std::size(s_profiles))
+        return {};
+
+    // Small scores and close languages are not reliable
+    const qreal confidence = (bestScore - secondScore) / bestScore * qMin(bestScore / s_sufficientScore, 1.0) * scriptRatio;
+    return {s_profiles[bestProfile].language, confidence};
+}
+
+QLanguageDetector::Script QLanguageDetector::script(char16_t character)
+{
+    // Only letters and marks are passed, so ranges include other characters of the blocks
+    if (character < 0x0370 || (character >= 0x1E00 && character < 0x1F00))
+        return LatinScript;
+    if (character < 0x0400)
+        return GreekScript;
+    if (character < 0x0530)
+        return CyrillicScript;
+    if (character < 0x0590)
+        return ArmenianScript;
+    if (character < 0x0600)
+        return HebrewScript;
+    if (character < 0x0780)
+        return ArabicScript;
+    if (character >= 0x0900 && character < 0x0980)
+        return DevanagariScript;
+    if (character >= 0x0980 && character < 0x0A00)
+        return BengaliScript;
+    if (character >= 0x0A00 && character < 0x0A80)
+        return GurmukhiScript;
+    if (character >= 0x0A80 && character < 0x0B00)
+        return GujaratiScript;
+    if (character >= 0x0B00 && character < 0x0B80)
+        return OriyaScript;
+    if (character >= 0x0B80 && character < 0x0C00)
+        return TamilScript;
+    if (character >= 0x0C00 && character < 0x0C80)
+        return TeluguScript;
+    if (character >= 0x0C80 && character < 0x0D00)
+        return KannadaScript;
+    if (character >= 0x0D00 && character < 0x0D80)
+        return MalayalamScript;
+    if (character >= 0x0D80 && character < 0x0E00)
+        return SinhalaScript;
+    if (character >= 0x0E00 && character < 0x0E80)
+        return ThaiScript;
+    if (character >= 0x0E80 && character < 0x0F00)
+        return LaoScript;
+    if (character >= 0x1000 && character < 0x10A0)
+        return MyanmarScript;
+    if ((character >= 0x10A0 && character < 0x1100) || (character >= 0x1C90 && character < 0x1CC0))
+        return GeorgianScript;
+    if ((character >= 0x1100 && character < 0x1200) || (character >= 0x3130 && character < 0x3190) || (character >= 0xAC00 && character < 0xD7B0))
+        return HangulScript;
+    if (character >= 0x1200 && character < 0x13A0)
+        return EthiopicScript;
+    if (character >= 0x1780 && character < 0x1800)
+        return KhmerScript;
+    if (character >= 0x1F00 && character < 0x2000)
+        return GreekScript;
+    if ((character >= 0x3040 && character < 0x3100) || (character >= 0x31F0 && character < 0x3200) || (character >= 0xFF66 && character < 0xFF9E))
+        return KanaScript;
+    if ((character >= 0x3400 && character < 0x4DC0) || (character >= 0x4E00 && character < 0xA000) || (character >= 0xF900 && character < 0xFB00))
+        return HanScript;
+    if ((character >= 0xFB50 && character < 0xFE00) || (character >= 0xFE70 && character < 0xFF00))
+        return ArabicScript;
+    if (character >= 0xFB1D && character < 0xFB50)
+        return HebrewScript;
+    return OtherScript;
+}
+
+const QLanguageDetector::Index &QLanguageDetector::index()
+{
+    // Built on first use to not require dynamic initialization on load
+    static const Index profilesIndex = [] {
+        Index index;
+        for (int profile = 0; profile < static_cast<int>(std::size(s_profiles)); ++profile) {
+            const std::u16string_view words = s_profiles[profile].words;
+            size_t wordStart = 0;
+            while (wordStart < words.size()) {
+                const size_t wordEnd = std::min(words.find(u' ', wordStart), words.size());
+                const QString word(reinterpret_cast<const QChar *>(words.data() + wordStart), static_cast<int>(wordEnd - wordStart));
+                QVector<int> &profiles = index.words[word];
+                if (!profiles.contains(profile))
+                    profiles.append(profile);
+                wordStart = wordEnd + 1;
+            }
+
+            for (char16_t letter : s_profiles[profile].letters) {
+                QVector<int> &profiles = index.letters[letter];
+                if (!profiles.contains(profile))
+                    profiles.append(profile);
+            }
+        }
+        return index;
+    }();
+    return profilesIndex;
+}
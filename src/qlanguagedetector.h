@@ -0,0 +1,133 @@
+/*
+ *  Copyright © 2018-2023 Hennadii Chernyshchyk <genaloner@gmail.com>
+ *
+ *  This file is part of QOnlineTranslator.
+ *
+ *  QOnlineTranslator is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  QOnlineTranslator is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with QOnlineTranslator. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef QLANGUAGEDETECTOR_H
+#define QLANGUAGEDETECTOR_H
+
+#include "qonlinetranslator.h"
+
+#include <QHash>
+#include <QVector>
+
+#include <string_view>
+
+/**
+ * @brief Detects language of the text without network requests
+ *
+ * Uses a compact built-in model: the writing system of the text and, for scripts that are shared by several languages,
+ * frequencies of the most common short words and of letters that are specific for a language.
+ * Languages with their own script are detected by the script alone.
+ * Not all languages have a profile, for such languages and for short or mixed texts the confidence is low,
+ * so the result should be checked against a threshold and the online detection should be used as a fallback.
+ *
+ * Example:
+ * @code
+ * const QLanguageDetector::Result result = QLanguageDetector::detect("Ich weiß nicht, ob er heute mit uns in die Stadt kommt");
+ * if (result.confidence >= 0.5)
+ *     qInfo() << QOnlineTranslator::languageName(result.language); // German
+ * @endcode
+ */
+class QLanguageDetector
+{
+public:
+    /**
+     * @brief Detection result
+     */
+    struct Result {
+        /**
+         * @brief Detected language
+         *
+         * QOnlineTranslator::NoLanguage if the language can't be detected.
+         */
+        QOnlineTranslator::Language language = QOnlineTranslator::NoLanguage;
+
+        /**
+         * @brief Confidence from 0 to 1
+         */
+        qreal confidence = 0;
+    };
+
+    /**
+     * @brief Detect language of the text
+     *
+     * Only the beginning of the text is analyzed, so the detection takes microseconds regardless of the text length.
+     *
+     * @param text text for language detection
+     * @return detected language and confidence
+     */
+    static Result detect(const QString &text);
+
+private:
+    enum Script {
+        LatinScript,
+        CyrillicScript,
+        GreekScript,
+        ArmenianScript,
+        GeorgianScript,
+        HebrewScript,
+        ArabicScript,
+        DevanagariScript,
+        BengaliScript,
+        GurmukhiScript,
+        GujaratiScript,
+        OriyaScript,
+        TamilScript,
+        TeluguScript,
+        KannadaScript,
+        MalayalamScript,
+        SinhalaScript,
+        ThaiScript,
+        LaoScript,
+        MyanmarScript,
+        EthiopicScript,
+        KhmerScript,
+        HangulScript,
+        KanaScript,
+        HanScript,
+        OtherScript,
+        ScriptsCount = OtherScript
+    };
+
+    // Frequent words and specific letters of a language that shares the script with other languages
+    struct Profile {
+        QOnlineTranslator::Language language;
+        Script script;
+        std::u16string_view words; // Separated by spaces, in lower case
+        std::u16string_view letters; // In lower case
+    };
+
+    // Profiles that contain a word or a letter
+    struct Index {
+        QHash<QString, QVector<int>> words;
+        QHash<ushort, QVector<int>> letters;
+    };
+
+    static Script script(char16_t character);
+    static const Index &index();
+
+    static const QOnlineTranslator::Language s_scriptLanguages[];
+    static const Profile s_profiles[];
+
+    static constexpr int s_textLimit = 1000;
+    static constexpr qreal s_letterWeight = 0.5;
+    static constexpr qreal s_sufficientScore = 3; // Score that is enough to trust the difference between languages
+    static constexpr qreal s_kanaRatio = 0.1; // Ratio of kana in Han text that indicates Japanese
+};
+
+#endif // QLANGUAGEDETECTOR_H
@@ -0,0 +1,172 @@
+/*
+ *  Copyright © 2018-2023 Hennadii Chernyshchyk <genaloner@gmail.com>
+ *
+ *  This file is part of QOnlineTranslator.
+ *
+ *  QOnlineTranslator is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  QOnlineTranslator is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with QOnlineTranslator. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "qlatencyhistogram.h"
+
+#include <QtAlgorithms>
+#include <QtMath>
+
+#include <chrono>
+
+QLatencyHistogram::QLatencyHistogram(qint64 slotDuration, int slotsCount)
+    : m_slotDuration(qMax<qint64>(slotDuration, 1))
+    , m_slotsCount(qMax(slotsCount, 1))
+    , m_slots(new Slot[m_slotsCount])
+{
+}
+
+void QLatencyHistogram::record(qint64 microseconds)
+{
+    const qint64 epoch = currentEpoch();
+    Slot &slot = m_slots[epoch % m_slotsCount];
+
+    // The first recorder in the new slot period clears the values left from the previous window
+    qint64 slotEpoch = slot.epoch.load(std::memory_order_acquire);
+    if (slotEpoch < epoch && slot.epoch.compare_exchange_strong(slotEpoch, epoch, std::memory_order_acq_rel)) {
+        for (std::atomic<quint64> &count : slot.counts)
+            count.store(0, std::memory_order_relaxed);
+    }
+
+    slot.counts[bucketIndex(microseconds)].fetch_add(1, std::memory_order_relaxed);
+}
+
+qint64 QLatencyHistogram::percentile(qreal percentile, qint64 window) const
+{
+    const qint64 epoch = currentEpoch();
+    const int slots = windowSlots(window);
+
+    quint64 counts[s_bucketsCount]{};
+    quint64 total = 0;
+    for (int i = 0; i < slots && i <= epoch; ++i) {
+        const Slot &slot = m_slots[(epoch - i) % m_slotsCount];
+        if (slot.epoch.load(std::memory_order_acquire) != epoch - i)
+            continue;
+
+        for (int bucket = 0; bucket < s_bucketsCount; ++bucket) {
+            const quint64 count = slot.counts[bucket].load(std::memory_order_relaxed);
+            counts[bucket] += count;
+            total += count;
+        }
+    }
+
+    if (total == 0)
+        return 0;
+
+    const auto target = qMax<quint64>(1, static_cast<quint64>(qCeil(qBound<qreal>(0, percentile, 100) / 100 * total)));
+    quint64 cumulativeCount = 0;
+    for (int bucket = 0; bucket < s_bucketsCount; ++bucket) {
+        cumulativeCount += counts[bucket];
+        if (cumulativeCount >= target)
+            return highestEquivalentValue(bucket);
+    }
+
+    return highestEquivalentValue(s_bucketsCount - 1);
+}
+
+quint64 QLatencyHistogram::count(qint64 window) const
+{
+    const qint64 epoch = currentEpoch();
+    const int slots = windowSlots(window);
+
+    quint64 total = 0;
+    for (int i = 0; i < slots && i <= epoch; ++i) {
+        const Slot &slot = m_slots[(epoch - i) % m_slotsCount];
+        if (slot.epoch.load(std::memory_order_acquire) != epoch - i)
+            continue;
+
+        for (const std::atomic<quint64> &count : slot.counts)
+            total += count.load(std::memory_order_relaxed);
+    }
+
+    return total;
+}
+
+QSharedPointer<QLatencyHistogram> QLatencyHistogram::instance(QOnlineTranslator::Engine engine, const QString &url)
+{
+    Registry &instances = registry();
+    const QPair<int, QString> key(engine, url);
+    {
+        QReadLocker locker(&instances.lock);
+        const QSharedPointer<QLatencyHistogram> histogram = instances.items.value(key);
+        if (histogram != nullptr)
+            return histogram;
+    }
+
+    QWriteLocker locker(&instances.lock);
+    QSharedPointer<QLatencyHistogram> &histogram = instances.items[key];
+    if (histogram == nullptr)
+        histogram = QSharedPointer<QLatencyHistogram>::create();
+    return histogram;
+}
+
+QHash<QString, QSharedPointer<QLatencyHistogram>> QLatencyHistogram::instances(QOnlineTranslator::Engine engine)
+{
+    QHash<QString, QSharedPointer<QLatencyHistogram>> histograms;
+
+    Registry &instances = registry();
+    QReadLocker locker(&instances.lock);
+    for (auto it = instances.items.cbegin(); it != instances.items.cend(); ++it) {
+        if (it.key().first == engine)
+            histograms.insert(it.key().second, it.value());
+    }
+
+    return histograms;
+}
+
+QLatencyHistogram::Registry &QLatencyHistogram::registry()
+{
+    static Registry registry;
+    return registry;
+}
+
+int QLatencyHistogram::bucketIndex(qint64 value)
+{
+    if (value < s_subBucketsCount)
+        return static_cast<int>(qMax<qint64>(value, 0));
+
+    const auto clampedValue = static_cast<quint64>(qMin(value, (Q_INT64_C(1) << (s_maxExponent + 1)) - 1));
+    const int exponent = 63 - qCountLeadingZeroBits(clampedValue);
+    const int subBucket = static_cast<int>(clampedValue >> (exponent - s_subBucketBits)) - s_subBucketsCount;
+    return (exponent - s_subBucketBits + 1) * s_subBucketsCount + subBucket;
+}
+
+qint64 QLatencyHistogram::highestEquivalentValue(int index)
+{
+    if (index < s_subBucketsCount)
+        return index;
+
+    const int exponent = index / s_subBucketsCount + s_subBucketBits - 1;
+    const int subBucket = index % s_subBucketsCount;
+    return ((static_cast<qint64>(s_subBucketsCount + subBucket + 1)) << (exponent - s_subBucketBits)) - 1;
+}
+
+qint64 QLatencyHistogram::currentEpoch() const
+{
+    const auto now = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch());
+    return now.count() / m_slotDuration;
+}
+
+int QLatencyHistogram::windowSlots(qint64 window) const
+{
+    if (window <= 0)
+        return m_slotsCount;
+
+    return static_cast<int>(qBound<qint64>(1, (window + m_slotDuration - 1) / m_slotDuration, m_slotsCount));
+}
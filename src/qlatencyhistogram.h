@@ -0,0 +1,138 @@
+/*
+ *  Copyright © 2018-2023 Hennadii Chernyshchyk <genaloner@gmail.com>
+ *
+ *  This file is part of QOnlineTranslator.
+ *
+ *  QOnlineTranslator is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  QOnlineTranslator is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with QOnlineTranslator. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef QLATENCYHISTOGRAM_H
+#define QLATENCYHISTOGRAM_H
+
+#include "qonlinetranslator.h"
+
+#include <QHash>
+#include <QReadWriteLock>
+#include <QSharedPointer>
+
+#include <atomic>
+#include <memory>
+
+/**
+ * @brief Collects latencies of requests for a rolling time window
+ *
+ * Values are stored in log-linear buckets with relative error below 6.25% (like in HdrHistogram with one significant digit),
+ * so recording and percentile queries do not depend on the number of recorded values.
+ * The window is divided into slots, the oldest slot is reused when the window moves forward.
+ *
+ * Recording is lock-free and can be done from any thread.
+ * Values recorded concurrently with the reuse of an outdated slot may be lost.
+ *
+ * Each QOnlineTranslator records latencies of its requests into the histogram of the used engine and instance URL.
+ *
+ * Example:
+ * @code
+ * const QSharedPointer<QLatencyHistogram> histogram = QLatencyHistogram::instance(QOnlineTranslator::LibreTranslate, "https://libretranslate.com");
+ * const qint64 p99 = histogram->percentile(99, 10000); // 99th percentile for the last 10 seconds in microseconds
+ * @endcode
+ */
+class QLatencyHistogram
+{
+    Q_DISABLE_COPY(QLatencyHistogram)
+
+public:
+    /**
+     * @brief Create histogram
+     *
+     * @param slotDuration duration of a single slot in milliseconds
+     * @param slotsCount number of slots, the window duration is `slotDuration * slotsCount`
+     */
+    explicit QLatencyHistogram(qint64 slotDuration = 5000, int slotsCount = 12);
+
+    /**
+     * @brief Record value
+     *
+     * @param microseconds latency in microseconds
+     */
+    void record(qint64 microseconds);
+
+    /**
+     * @brief Value at percentile
+     *
+     * @param percentile percentile from 0 to 100
+     * @param window duration in milliseconds to take into account, 0 for the whole window
+     * @return highest value that is equivalent to the value at the percentile or 0 if there are no values
+     */
+    qint64 percentile(qreal percentile, qint64 window = 0) const;
+
+    /**
+     * @brief Number of recorded values
+     *
+     * @param window duration in milliseconds to take into account, 0 for the whole window
+     * @return number of values
+     */
+    quint64 count(qint64 window = 0) const;
+
+    /**
+     * @brief Histogram of the engine instance
+     *
+     * Creates the histogram on the first call.
+     *
+     * @param engine engine
+     * @param url instance URL of the engine
+     * @return histogram that is used by all QOnlineTranslator objects for this instance
+     */
+    static QSharedPointer<QLatencyHistogram> instance(QOnlineTranslator::Engine engine, const QString &url);
+
+    /**
+     * @brief Histograms of all used instances of the engine
+     *
+     * @param engine engine
+     * @return instance URLs and their histograms
+     */
+    static QHash<QString, QSharedPointer<QLatencyHistogram>> instances(QOnlineTranslator::Engine engine);
+
+private:
+    // 16 linear sub-buckets for each power of two, values above 2^36 microseconds (~19 hours) are clamped
+    static constexpr int s_subBucketBits = 4;
+    static constexpr int s_subBucketsCount = 1 << s_subBucketBits;
+    static constexpr int s_maxExponent = 35;
+    static constexpr int s_bucketsCount = (s_maxExponent - s_subBucketBits + 2) * s_subBucketsCount;
+
+    struct Slot {
+        std::atomic<qint64> epoch{-1};
+        std::atomic<quint64> counts[s_bucketsCount]{};
+    };
+
+    static int bucketIndex(qint64 value);
+    static qint64 highestEquivalentValue(int index);
+
+    qint64 currentEpoch() const;
+    int windowSlots(qint64 window) const;
+
+    const qint64 m_slotDuration;
+    const int m_slotsCount;
+    std::unique_ptr<Slot[]> m_slots;
+
+    // Created on the first use, so the library does no work at load time
+    struct Registry {
+        QReadWriteLock lock;
+        QHash<QPair<int, QString>, QSharedPointer<QLatencyHistogram>> items;
+    };
+
+    static Registry &registry();
+};
+
+#endif // QLATENCYHISTOGRAM_H
@@ -19,7 +19,16 @@
 
 #include "qonlinetranslator.h"
 
+#include "qdictionarycache.h"
+#include "qlanguagedetector.h"
+#include "qlatencyhistogram.h"
 #include "qonlinetts.h"
+#include "qpercentencoder.h"
+#include "qscripthistogram.h"
+#include "qtranslationmetrics.h"
+#include "qtranslationresult.h"
+#include "qtranslationtracer.h"
+#include "qtransliterator.h"
 
 #include <QCoreApplication>
 #include <QFinalState>
@@ -28,236 +37,538 @@
 #include <QJsonObject>
 #include <QMediaPlayer>
 #include <QNetworkReply>
+#include <QSignalTransition>
 #include <QStateMachine>
+#include <QUuid>
 
-const QMap<QOnlineTranslator::Language, QString> QOnlineTranslator::s_genericLanguageCodes = {
-    {Auto, QStringLiteral("auto")},
-    {Afrikaans, QStringLiteral("af")},
-    {Albanian, QStringLiteral("sq")},
-    {Amharic, QStringLiteral("am")},
-    {Arabic, QStringLiteral("ar")},
-    {Armenian, QStringLiteral("hy")},
-    {Azerbaijani, QStringLiteral("az")},
-    {Bashkir, QStringLiteral("ba")},
-    {Basque, QStringLiteral("eu")},
-    {Belarusian, QStringLiteral("be")},
-    {Bengali, QStringLiteral("bn")},
-    {Bosnian, QStringLiteral("bs")},
-    {Bulgarian, QStringLiteral("bg")},
-    {Cantonese, QStringLiteral("yue")},
-    {Catalan, QStringLiteral("ca")},
-    {Cebuano, QStringLiteral("ceb")},
-    {Chichewa, QStringLiteral("ny")},
-    {Corsican, QStringLiteral("co")},
-    {Croatian, QStringLiteral("hr")},
-    {Czech, QStringLiteral("cs")},
-    {Danish, QStringLiteral("da")},
-    {Dutch, QStringLiteral("nl")},
-    {English, QStringLiteral("en")},
-    {Esperanto, QStringLiteral("eo")},
-    {Estonian, QStringLiteral("et")},
-    {Fijian, QStringLiteral("fj")},
-    {Filipino, QStringLiteral("fil")},
-    {Finnish, QStringLiteral("fi")},
-    {French, QStringLiteral("fr")},
-    {Frisian, QStringLiteral("fy")},
-    {Galician, QStringLiteral("gl")},
-    {Georgian, QStringLiteral("ka")},
-    {German, QStringLiteral("de")},
-    {Greek, QStringLiteral("el")},
-    {Gujarati, QStringLiteral("gu")},
-    {HaitianCreole, QStringLiteral("ht")},
-    {Hausa, QStringLiteral("ha")},
-    {Hawaiian, QStringLiteral("haw")},
-    {Hebrew, QStringLiteral("he")},
-    {HillMari, QStringLiteral("mrj")},
-    {Hindi, QStringLiteral("hi")},
-    {Hmong, QStringLiteral("hmn")},
-    {Hungarian, QStringLiteral("hu")},
-    {Icelandic, QStringLiteral("is")},
-    {Igbo, QStringLiteral("ig")},
-    {Indonesian, QStringLiteral("id")},
-    {Irish, QStringLiteral("ga")},
-    {Italian, QStringLiteral("it")},
-    {Japanese, QStringLiteral("ja")},
-    {Javanese, QStringLiteral("jw")},
-    {Kannada, QStringLiteral("kn")},
-    {Kazakh, QStringLiteral("kk")},
-    {Khmer, QStringLiteral("km")},
-    {Kinyarwanda, QStringLiteral("rw")},
-    {Klingon, QStringLiteral("tlh")},
-    {KlingonPlqaD, QStringLiteral("tlh-Qaak")},
-    {Korean, QStringLiteral("ko")},
-    {Kurdish, QStringLiteral("ku")},
-    {Kyrgyz, QStringLiteral("ky")},
-    {Lao, QStringLiteral("lo")},
-    {Latin, QStringLiteral("la")},
-    {Latvian, QStringLiteral("lv")},
-    {LevantineArabic, QStringLiteral("apc")},
-    {Lithuanian, QStringLiteral("lt")},
-    {Luxembourgish, QStringLiteral("lb")},
-    {Macedonian, QStringLiteral("mk")},
-    {Malagasy, QStringLiteral("mg")},
-    {Malay, QStringLiteral("ms")},
-    {Malayalam, QStringLiteral("ml")},
-    {Maltese, QStringLiteral("mt")},
-    {Maori, QStringLiteral("mi")},
-    {Marathi, QStringLiteral("mr")},
-    {Mari, QStringLiteral("mhr")},
-    {Mongolian, QStringLiteral("mn")},
-    {Myanmar, QStringLiteral("my")},
-    {Nepali, QStringLiteral("ne")},
-    {Norwegian, QStringLiteral("no")},
-    {Oriya, QStringLiteral("or")},
-    {Papiamento, QStringLiteral("pap")},
-    {Pashto, QStringLiteral("ps")},
-    {Persian, QStringLiteral("fa")},
-    {Polish, QStringLiteral("pl")},
-    {Portuguese, QStringLiteral("pt")},
-    {Punjabi, QStringLiteral("pa")},
-    {QueretaroOtomi, QStringLiteral("otq")},
-    {Romanian, QStringLiteral("ro")},
-    {Russian, QStringLiteral("ru")},
-    {Samoan, QStringLiteral("sm")},
-    {ScotsGaelic, QStringLiteral("gd")},
-    {SerbianCyrillic, QStringLiteral("sr")},
-    {SerbianLatin, QStringLiteral("sr-Latin")},
-    {Sesotho, QStringLiteral("st")},
-    {Shona, QStringLiteral("sn")},
-    {SimplifiedChinese, QStringLiteral("zh-CN")},
-    {Sindhi, QStringLiteral("sd")},
-    {Sinhala, QStringLiteral("si")},
-    {Slovak, QStringLiteral("sk")},
-    {Slovenian, QStringLiteral("sl")},
-    {Somali, QStringLiteral("so")},
-    {Spanish, QStringLiteral("es")},
-    {Sundanese, QStringLiteral("su")},
-    {Swahili, QStringLiteral("sw")},
-    {Swedish, QStringLiteral("sv")},
-    {Tagalog, QStringLiteral("tl")},
-    {Tahitian, QStringLiteral("ty")},
-    {Tajik, QStringLiteral("tg")},
-    {Tamil, QStringLiteral("ta")},
-    {Tatar, QStringLiteral("tt")},
-    {Telugu, QStringLiteral("te")},
-    {Thai, QStringLiteral("th")},
-    {Tongan, QStringLiteral("to")},
-    {TraditionalChinese, QStringLiteral("zh-TW")},
-    {Turkish, QStringLiteral("tr")},
-    {Turkmen, QStringLiteral("tk")},
-    {Udmurt, QStringLiteral("udm")},
-    {Uighur, QStringLiteral("ug")},
-    {Ukrainian, QStringLiteral("uk")},
-    {Urdu, QStringLiteral("ur")},
-    {Uzbek, QStringLiteral("uz")},
-    {Vietnamese, QStringLiteral("vi")},
-    {Welsh, QStringLiteral("cy")},
-    {Xhosa, QStringLiteral("xh")},
-    {Yiddish, QStringLiteral("yi")},
-    {Yoruba, QStringLiteral("yo")},
-    {YucatecMaya, QStringLiteral("yua")},
-    {Zulu, QStringLiteral("zu")}};
-
-const QMap<QOnlineTranslator::Language, QString> QOnlineTranslator::s_googleLanguageCodes = {
-    {Hebrew, QStringLiteral("iw")}};
-
-const QMap<QOnlineTranslator::Language, QString> QOnlineTranslator::s_yandexLanguageCodes = {
-    {SimplifiedChinese, QStringLiteral("zn")},
-    {Javanese, QStringLiteral("jv")}};
-
-const QMap<QOnlineTranslator::Language, QString> QOnlineTranslator::s_bingLanguageCodes = {
-    {Auto, QStringLiteral("auto-detect")},
-    {Bosnian, QStringLiteral("bs-Latn")},
-    {SerbianCyrillic, QStringLiteral("sr-Cyrl")},
-    {SimplifiedChinese, QStringLiteral("zh-Hans")},
-    {TraditionalChinese, QStringLiteral("zh-Hant")},
-    {Hmong, QStringLiteral("mww")}};
-
-const QMap<QOnlineTranslator::Language, QString> QOnlineTranslator::s_lingvaLanguageCodes = {
-    {SimplifiedChinese, QStringLiteral("zh")},
-    {TraditionalChinese, QStringLiteral("zh_HANT")}};
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+namespace {
+// Network manager can be shared between translators, so only the own reply should finish the request
+class ReplyFinishedTransition : public QSignalTransition
+{
+public:
+    ReplyFinishedTransition(QNetworkAccessManager *manager, const QPointer<QNetworkReply> &reply)
+        : QSignalTransition(manager, &QNetworkAccessManager::finished)
+        , m_reply(reply)
+    {
+    }
+
+protected:
+    bool eventTest(QEvent *event) override
+    {
+        if (!QSignalTransition::eventTest(event))
+            return false;
+
+        const auto *signalEvent = static_cast<QStateMachine::SignalEvent *>(event);
+        return signalEvent->arguments().constFirst().value<QNetworkReply *>() == m_reply;
+    }
+
+private:
+    const QPointer<QNetworkReply> &m_reply;
+};
+} // namespace
+
+// Indexed by language, so must follow the order of the enum
+constexpr std::u16string_view QOnlineTranslator::s_genericLanguageCodes[] = {
+    u"auto", // Auto
+    u"af", // Afrikaans
+    u"sq", // Albanian
+    u"am", // Amharic
+    u"ar", // Arabic
+    u"hy", // Armenian
+    u"az", // Azerbaijani
+    u"ba", // Bashkir
+    u"eu", // Basque
+    u"be", // Belarusian
+    u"bn", // Bengali
+    u"bs", // Bosnian
+    u"bg", // Bulgarian
+    u"yue", // Cantonese
+    u"ca", // Catalan
+    u"ceb", // Cebuano
+    u"ny", // Chichewa
+    u"co", // Corsican
+    u"hr", // Croatian
+    u"cs", // Czech
+    u"da", // Danish
+    u"nl", // Dutch
+    u"en", // English
+    u"eo", // Esperanto
+    u"et", // Estonian
+    u"fj", // Fijian
+    u"fil", // Filipino
+    u"fi", // Finnish
+    u"fr", // French
+    u"fy", // Frisian
+    u"gl", // Galician
+    u"ka", // Georgian
+    u"de", // German
+    u"el", // Greek
+    u"gu", // Gujarati
+    u"ht", // HaitianCreole
+    u"ha", // Hausa
+    u"haw", // Hawaiian
+    u"he", // Hebrew
+    u"mrj", // HillMari
+    u"hi", // Hindi
+    u"hmn", // Hmong
+    u"hu", // Hungarian
+    u"is", // Icelandic
+    u"ig", // Igbo
+    u"id", // Indonesian
+    u"ga", // Irish
+    u"it", // Italian
+    u"ja", // Japanese
+    u"jw", // Javanese
+    u"kn", // Kannada
+    u"kk", // Kazakh
+    u"km", // Khmer
+    u"rw", // Kinyarwanda
+    u"tlh", // Klingon
+    u"tlh-Qaak", // KlingonPlqaD
+    u"ko", // Korean
+    u"ku", // Kurdish
+    u"ky", // Kyrgyz
+    u"lo", // Lao
+    u"la", // Latin
+    u"lv", // Latvian
+    u"apc", // LevantineArabic
+    u"lt", // Lithuanian
+    u"lb", // Luxembourgish
+    u"mk", // Macedonian
+    u"mg", // Malagasy
+    u"ms", // Malay
+    u"ml", // Malayalam
+    u"mt", // Maltese
+    u"mi", // Maori
+    u"mr", // Marathi
+    u"mhr", // Mari
+    u"mn", // Mongolian
+    u"my", // Myanmar
+    u"ne", // Nepali
+    u"no", // Norwegian
+    u"or", // Oriya
+    u"pap", // Papiamento
+    u"ps", // Pashto
+    u"fa", // Persian
+    u"pl", // Polish
+    u"pt", // Portuguese
+    u"pa", // Punjabi
+    u"otq", // QueretaroOtomi
+    u"ro", // Romanian
+    u"ru", // Russian
+    u"sm", // Samoan
+    u"gd", // ScotsGaelic
+    u"sr", // SerbianCyrillic
+    u"sr-Latin", // SerbianLatin
+    u"st", // Sesotho
+    u"sn", // Shona
+    u"zh-CN", // SimplifiedChinese
+    u"sd", // Sindhi
+    u"si", // Sinhala
+    u"sk", // Slovak
+    u"sl", // Slovenian
+    u"so", // Somali
+    u"es", // Spanish
+    u"su", // Sundanese
+    u"sw", // Swahili
+    u"sv", // Swedish
+    u"tl", // Tagalog
+    u"ty", // Tahitian
+    u"tg", // Tajik
+    u"ta", // Tamil
+    u"tt", // Tatar
+    u"te", // Telugu
+    u"th", // Thai
+    u"to", // Tongan
+    u"zh-TW", // TraditionalChinese
+    u"tr", // Turkish
+    u"tk", // Turkmen
+    u"udm", // Udmurt
+    u"ug", // Uighur
+    u"uk", // Ukrainian
+    u"ur", // Urdu
+    u"uz", // Uzbek
+    u"vi", // Vietnamese
+    u"cy", // Welsh
+    u"xh", // Xhosa
+    u"yi", // Yiddish
+    u"yo", // Yoruba
+    u"yua", // YucatecMaya
+    u"zu", // Zulu
+};
+
+// Builds code table with engine exceptions applied and reverse index sorted by code at compile time
+template<size_t N>
+constexpr QOnlineTranslator::LanguageCodesTable<N> QOnlineTranslator::makeLanguageCodes(const std::array<LanguageCode, N> &exceptions)
+{
+    static_assert(std::size(s_genericLanguageCodes) == s_languagesCount, "Generic codes should be specified for all languages");
+
+    LanguageCodesTable<N> table{};
+    for (size_t i = 0; i < s_languagesCount; ++i)
+        table.codes[i] = s_genericLanguageCodes[i];
+
+    // Exceptions are placed first to be found before generic codes with the same value after stable sort
+    for (size_t i = 0; i < N; ++i) {
+        table.codes[exceptions[i].language] = exceptions[i].code;
+        table.index[i] = exceptions[i];
+    }
+    for (size_t i = 0; i < s_languagesCount; ++i)
+        table.index[N + i] = {static_cast<Language>(i), s_genericLanguageCodes[i]};
+
+    for (size_t i = 1; i < table.index.size(); ++i) {
+        const LanguageCode entry = table.index[i];
+        size_t j = i;
+        for (; j > 0 && entry.code < table.index[j - 1].code; --j)
+            table.index[j] = table.index[j - 1];
+        table.index[j] = entry;
+    }
+
+    return table;
+}
+
+constexpr QOnlineTranslator::LanguageCodesTable<0> QOnlineTranslator::s_genericLanguageCodesTable = makeLanguageCodes<0>({});
+
+// Engines have some language codes exceptions
+constexpr QOnlineTranslator::LanguageCodesTable<1> QOnlineTranslator::s_googleLanguageCodes = makeLanguageCodes<1>({{
+    {Hebrew, u"iw"},
+}});
+
+constexpr QOnlineTranslator::LanguageCodesTable<2> QOnlineTranslator::s_yandexLanguageCodes = makeLanguageCodes<2>({{
+    {SimplifiedChinese, u"zn"},
+    {Javanese, u"jv"},
+}});
+
+constexpr QOnlineTranslator::LanguageCodesTable<6> QOnlineTranslator::s_bingLanguageCodes = makeLanguageCodes<6>({{
+    {Auto, u"auto-detect"},
+    {Bosnian, u"bs-Latn"},
+    {SerbianCyrillic, u"sr-Cyrl"},
+    {SimplifiedChinese, u"zh-Hans"},
+    {TraditionalChinese, u"zh-Hant"},
+    {Hmong, u"mww"},
+}});
+
+constexpr QOnlineTranslator::LanguageCodesTable<2> QOnlineTranslator::s_lingvaLanguageCodes = makeLanguageCodes<2>({{
+    {SimplifiedChinese, u"zh"},
+    {TraditionalChinese, u"zh_HANT"},
+}});
+
+constexpr QOnlineTranslator::LanguageSet QOnlineTranslator::s_googleLanguages = LanguageSet::all() - LanguageSet{
+    Bashkir,
+    Cantonese,
+    Fijian,
+    Filipino,
+    Georgian,
+    HillMari,
+    Klingon,
+    KlingonPlqaD,
+    LevantineArabic,
+    Mari,
+    Papiamento,
+    QueretaroOtomi,
+    SerbianLatin,
+    Tahitian,
+    Tongan,
+    Udmurt,
+    YucatecMaya,
+};
+
+constexpr QOnlineTranslator::LanguageSet QOnlineTranslator::s_yandexLanguages = LanguageSet::all() - LanguageSet{
+    Cantonese,
+    Chichewa,
+    Corsican,
+    Fijian,
+    Filipino,
+    Frisian,
+    Hausa,
+    Hawaiian,
+    Igbo,
+    Kinyarwanda,
+    Klingon,
+    KlingonPlqaD,
+    Kurdish,
+    LevantineArabic,
+    Oriya,
+    Pashto,
+    QueretaroOtomi,
+    Samoan,
+    SerbianLatin,
+    Sesotho,
+    Shona,
+    Sindhi,
+    Somali,
+    Tahitian,
+    Tongan,
+    Turkmen,
+    Uighur,
+    Yoruba,
+    YucatecMaya,
+    Zulu,
+};
+
+constexpr QOnlineTranslator::LanguageSet QOnlineTranslator::s_bingLanguages = LanguageSet::all() - LanguageSet{
+    Albanian,
+    Amharic,
+    Armenian,
+    Azerbaijani,
+    Basque,
+    Bashkir,
+    Belarusian,
+    Cebuano,
+    Corsican,
+    Esperanto,
+    Frisian,
+    Galician,
+    Georgian,
+    Gujarati,
+    Hausa,
+    Hawaiian,
+    HillMari,
+    Igbo,
+    Irish,
+    Javanese,
+    Kannada,
+    Kazakh,
+    Khmer,
+    Kinyarwanda,
+    Kurdish,
+    Kyrgyz,
+    Lao,
+    Latin,
+    Luxembourgish,
+    Macedonian,
+    Malayalam,
+    Maori,
+    Marathi,
+    Mari,
+    Mongolian,
+    Myanmar,
+    Nepali,
+    Oriya,
+    Chichewa,
+    Papiamento,
+    Pashto,
+    Punjabi,
+    ScotsGaelic,
+    Sesotho,
+    Shona,
+    Sindhi,
+    Sinhala,
+    Somali,
+    Sundanese,
+    Tagalog,
+    Tajik,
+    Tatar,
+    Turkmen,
+    Uighur,
+    Udmurt,
+    Uzbek,
+    Xhosa,
+    Yiddish,
+    Yoruba,
+    Zulu,
+};
+
+constexpr QOnlineTranslator::LanguageSet QOnlineTranslator::s_libreTranslateLanguages = {
+    Auto,
+    Arabic,
+    English,
+    French,
+    German,
+    Hindi,
+    Indonesian,
+    Irish,
+    Italian,
+    Japanese,
+    Korean,
+    Polish,
+    Portuguese,
+    Russian,
+    Spanish,
+    TraditionalChinese,
+    Turkish,
+    Vietnamese,
+};
+
+// Indexed by engine
+constexpr QOnlineTranslator::LanguageSet QOnlineTranslator::s_translationLanguages[] = {
+    s_googleLanguages,
+    s_yandexLanguages,
+    s_bingLanguages,
+    s_libreTranslateLanguages,
+    s_googleLanguages, // Lingva is a frontend to Google Translate
+};
+
+// Indexed by engine
+constexpr QOnlineTranslator::LanguageSet QOnlineTranslator::s_translitLanguages[] = {
+    s_googleLanguages, // Google supports transliteration for all supported languages
+    LanguageSet{
+        Amharic,
+        Armenian,
+        Bengali,
+        SimplifiedChinese,
+        Georgian,
+        Greek,
+        Gujarati,
+        Hebrew,
+        Hindi,
+        Japanese,
+        Kannada,
+        Korean,
+        Malayalam,
+        Marathi,
+        Nepali,
+        Punjabi,
+        Russian,
+        Sinhala,
+        Tamil,
+        Telugu,
+        Thai,
+        Yiddish,
+    },
+    LanguageSet{
+        Arabic,
+        Bengali,
+        Gujarati,
+        Hebrew,
+        Hindi,
+        Japanese,
+        Kannada,
+        Malayalam,
+        Marathi,
+        Punjabi,
+        SerbianCyrillic,
+        SerbianLatin,
+        Tamil,
+        Telugu,
+        Thai,
+        SimplifiedChinese,
+        TraditionalChinese,
+    },
+    LanguageSet{}, // LibreTranslate doesn't support translit
+    s_googleLanguages,
+};
 
 QOnlineTranslator::QOnlineTranslator(QObject *parent)
     : QObject(parent)
     , m_stateMachine(new QStateMachine(this))
     , m_networkManager(new QNetworkAccessManager(this))
-{
-    connect(m_stateMachine, &QStateMachine::finished, this, &QOnlineTranslator::finished);
+    , m_result(new QTranslationResultData)
+{
+    // Connected first to have measurements ready in the slots connected by the user
+    connect(this, &QOnlineTranslator::finished, this, &QOnlineTranslator::finishMeasurement);
+    connect(m_stateMachine, &QStateMachine::finished, this, &QOnlineTranslator::onStateMachineFinished);
+    connect(this, &QOnlineTranslator::chunkTranslated, this, [this](int index, const QString &text) {
+        if (m_incremental)
+            m_changedSegments[index].translation = text;
+    });
     connect(m_stateMachine, &QStateMachine::stopped, this, &QOnlineTranslator::finished);
 }
 
+QOnlineTranslator::~QOnlineTranslator() = default;
+
 void QOnlineTranslator::translate(const QString &text, Engine engine, Language translationLang, Language sourceLang, Language uiLang)
 {
     abort();
-    resetData();
+    m_streaming = false;
+    m_incremental = false;
+    startTranslation(text, engine, translationLang, sourceLang, uiLang);
+}
 
-    m_onlyDetectLanguage = false;
-    m_source = text;
-    m_sourceLang = sourceLang;
-    m_translationLang = translationLang == Auto ? language(QLocale()) : translationLang;
-    m_uiLang = uiLang == Auto ? language(QLocale()) : uiLang;
+void QOnlineTranslator::translateIncremental(const QString &text, Engine engine, Language translationLang, Language sourceLang, Language uiLang)
+{
+    abort();
+    m_streaming = false;
 
-    // Check if the selected languages are supported by the engine
-    if (!isSupportTranslation(engine, m_sourceLang)) {
-        resetData(ParametersError, tr("Selected source language %1 is not supported for %2").arg(languageName(m_sourceLang), QMetaEnum::fromType<Engine>().valueToKey(engine)));
-        emit finished();
-        return;
-    }
-    if (!isSupportTranslation(engine, m_translationLang)) {
-        resetData(ParametersError, tr("Selected translation language %1 is not supported for %2").arg(languageName(m_translationLang), QMetaEnum::fromType<Engine>().valueToKey(engine)));
-        emit finished();
-        return;
+    // Segments can be reused only for the same parameters
+    const IncrementalParameters parameters{engine, translationLang, sourceLang, uiLang};
+    if (parameters != m_segmentsParameters) {
+        m_segments.clear();
+        m_segmentsParameters = parameters;
     }
-    if (!isSupportTranslation(engine, m_uiLang)) {
-        resetData(ParametersError, tr("Selected ui language %1 is not supported for %2").arg(languageName(m_uiLang), QMetaEnum::fromType<Engine>().valueToKey(engine)));
-        emit finished();
-        return;
+
+    // Find segments that are not changed at the beginning and the end of the text
+    int prefixSize = 0;
+    int changedStart = 0;
+    while (prefixSize < m_segments.size() && text.midRef(changedStart).startsWith(m_segments.at(prefixSize).source)) {
+        changedStart += m_segments.at(prefixSize).source.size();
+        ++prefixSize;
     }
 
-    switch (engine) {
-    case Google:
-        buildGoogleStateMachine();
-        break;
-    case Yandex:
-        buildYandexStateMachine();
-        break;
-    case Bing:
-        buildBingStateMachine();
-        break;
-    case LibreTranslate:
-        if (m_libreUrl.isEmpty()) {
-            resetData(ParametersError, tr("%1 URL can't be empty.").arg(QMetaEnum::fromType<Engine>().valueToKey(engine)));
-            emit finished();
-            return;
-        }
+    int suffixSize = 0;
+    int changedEnd = text.size();
+    while (prefixSize + suffixSize < m_segments.size()) {
+        const QString &source = m_segments.at(m_segments.size() - suffixSize - 1).source;
+        if (changedEnd - source.size() < changedStart || !text.midRef(changedStart, changedEnd - changedStart).endsWith(source))
+            break;
 
-        buildLibreStateMachine();
-        break;
-    case Lingva:
-        if (m_lingvaUrl.isEmpty()) {
-            resetData(ParametersError, tr("%1 URL can't be empty.").arg(QMetaEnum::fromType<Engine>().valueToKey(engine)));
-            emit finished();
-            return;
-        }
+        changedEnd -= source.size();
+        ++suffixSize;
+    }
 
-        buildLingvaStateMachine();
-        break;
+    m_incremental = true;
+    m_incrementalSource = text;
+    m_unchangedPrefixSize = prefixSize;
+    m_unchangedSuffixSize = suffixSize;
+    m_changedSegments.clear();
+
+    // Nothing to send if only unchanged segments were added or removed
+    if (changedStart == changedEnd && !m_segments.isEmpty()) {
+        resetData();
+        m_onlyDetectLanguage = false;
+        m_result->engine = engine;
+        startMeasurement();
+        m_result->sourceLang = m_segmentsSourceLang;
+        m_result->translationLang = translationLang == Auto ? language(QLocale()) : translationLang;
+        m_uiLang = uiLang == Auto ? language(QLocale()) : uiLang;
+        finishIncrementalTranslation();
+        emit finished();
+        return;
     }
 
-    m_stateMachine->start();
+    startTranslation(text.mid(changedStart, changedEnd - changedStart), engine, translationLang, sourceLang, uiLang);
+}
+
+void QOnlineTranslator::translate(QIODevice *input, QIODevice *output, Engine engine, Language translationLang, Language sourceLang, Language uiLang)
+{
+    abort();
+    m_incremental = false;
+    m_streaming = true;
+    m_streamInput = input;
+    m_streamOutput = output;
+    m_streamBuffer.clear();
+    m_streamIncompleteBytes.clear();
+    m_streamSpaceNeeded = false;
+    startTranslation(readStreamSegment(), engine, translationLang, sourceLang, uiLang);
 }
 
 void QOnlineTranslator::detectLanguage(const QString &text, Engine engine)
 {
     abort();
     resetData();
+    m_streaming = false;
+    m_incremental = false;
 
     m_onlyDetectLanguage = true;
-    m_source = text;
-    m_sourceLang = Auto;
-    m_translationLang = English;
+    m_result->engine = engine;
+    startMeasurement();
+    m_result->source = text;
+    m_result->sourceLang = Auto;
+    m_result->translationLang = English;
     m_uiLang = language(QLocale());
 
+    if (m_offlineLanguageDetectionEnabled) {
+        const QLanguageDetector::Result detection = QLanguageDetector::detect(text);
+        if (detection.confidence >= s_offlineDetectionConfidence && isSupportTranslation(engine, detection.language)) {
+            m_result->sourceLang = detection.language;
+            emit finished();
+            return;
+        }
+    }
+
     switch (engine) {
     case Google:
         buildGoogleDetectStateMachine();
@@ -291,6 +602,29 @@ void QOnlineTranslator::detectLanguage(const QString &text, Engine engine)
     m_stateMachine->start();
 }
 
+void QOnlineTranslator::preconnect(Engine engine)
+{
+    switch (engine) {
+    case Google:
+        preconnectToHost(QUrl(m_googleUrl));
+        break;
+    case Yandex:
+        preconnectToHost(QUrl(m_yandexUrl));
+        if (m_translationOptionsEnabled && m_yandexDictionaryUrl != m_yandexUrl)
+            preconnectToHost(QUrl(m_yandexDictionaryUrl));
+        break;
+    case Bing:
+        preconnectToHost(QUrl(m_bingUrl));
+        break;
+    case LibreTranslate:
+        preconnectToHost(QUrl(m_libreUrl));
+        break;
+    case Lingva:
+        preconnectToHost(QUrl(m_lingvaUrl));
+        break;
+    }
+}
+
 void QOnlineTranslator::abort()
 {
     if (m_currentReply != nullptr)
@@ -302,100 +636,111 @@ bool QOnlineTranslator::isRunning() const
     return m_stateMachine->isRunning();
 }
 
-QJsonDocument QOnlineTranslator::toJson() const
+void QOnlineTranslator::fetchDictionary()
 {
-    QJsonObject translationOptions;
-    for (auto it = m_translationOptions.cbegin(); it != m_translationOptions.cend(); ++it) {
-        QJsonArray arr;
-        for (const QOption &option : it.value())
-            arr.append(option.toJson());
-        translationOptions.insert(it.key(), arr);
+    if (isRunning()) {
+        m_dictionaryRequested = true;
+        return;
     }
 
-    QJsonObject examples;
-    for (auto it = m_examples.cbegin(); it != m_examples.cend(); ++it) {
-        QJsonArray arr;
-        for (const QExample &example : it.value())
-            arr.append(example.toJson());
-        examples.insert(it.key(), arr);
+    if (!m_dictionaryPending) {
+        emit dictionaryFetched();
+        return;
     }
 
-    QJsonObject object{
-        {"examples", qMove(examples)},
-        {"source", m_source},
-        {"sourceTranscription", m_sourceTranscription},
-        {"sourceTranslit", m_sourceTranslit},
-        {"translation", m_translation},
-        {"translationOptions", qMove(translationOptions)},
-        {"translationTranslit", m_translationTranslit},
-    };
+    // Reuse the state machine, the translation data is kept
+    m_dictionaryPending = false;
+    m_fetchingDictionary = true;
+    startMeasurement();
+    resetStateMachine();
+    buildDictionaryStateMachine();
+    m_stateMachine->start();
+}
+
+QJsonDocument QOnlineTranslator::toJson() const
+{
+    return QJsonDocument(result().toJson());
+}
+
+QTranslationResult QOnlineTranslator::result() const
+{
+    return QTranslationResult(m_result);
+}
 
-    return QJsonDocument(object);
+QTranslationResult QOnlineTranslator::takeResult()
+{
+    m_dictionaryPending = false;
+    return QTranslationResult(std::exchange(m_result, QSharedDataPointer<QTranslationResultData>(new QTranslationResultData)));
 }
 
 QString QOnlineTranslator::source() const
 {
-    return m_source;
+    return m_result->source;
 }
 
 QString QOnlineTranslator::sourceTranslit() const
 {
-    return m_sourceTranslit;
+    return m_result->sourceTranslit;
 }
 
 QString QOnlineTranslator::sourceTranscription() const
 {
-    return m_sourceTranscription;
+    return m_result->sourceTranscription;
 }
 
 QString QOnlineTranslator::sourceLanguageName() const
 {
-    return languageName(m_sourceLang);
+    return languageName(m_result->sourceLang);
 }
 
 QOnlineTranslator::Language QOnlineTranslator::sourceLanguage() const
 {
-    return m_sourceLang;
+    return m_result->sourceLang;
 }
 
 QString QOnlineTranslator::translation() const
 {
-    return m_translation;
+    return m_result->translation;
 }
 
 QString QOnlineTranslator::translationTranslit() const
 {
-    return m_translationTranslit;
+    return m_result->translationTranslit;
 }
 
 QString QOnlineTranslator::translationLanguageName() const
 {
-    return languageName(m_translationLang);
+    return languageName(m_result->translationLang);
 }
 
 QOnlineTranslator::Language QOnlineTranslator::translationLanguage() const
 {
-    return m_translationLang;
+    return m_result->translationLang;
 }
 
 QMap<QString, QVector<QOption>> QOnlineTranslator::translationOptions() const
 {
-    return m_translationOptions;
+    return m_result->translationOptions;
 }
 
 QMap<QString, QVector<QExample>> QOnlineTranslator::examples() const
 {
-    return m_examples;
+    return m_result->examples;
+}
+
+QTranslationTimings QOnlineTranslator::timings() const
+{
+    return m_timings;
 }
 
 QOnlineTranslator::TranslationError QOnlineTranslator::error() const
 {
-    return m_error;
+    return m_result->error;
 }
 
 QString QOnlineTranslator::errorString() const
 {
-    return m_errorString;
+    return m_result->errorString;
 }
 
 bool QOnlineTranslator::isSourceTranslitEnabled() const
@@ -448,9 +793,40 @@ void QOnlineTranslator::setExamplesEnabled(bool enable)
     m_examplesEnabled = enable;
 }
 
+bool QOnlineTranslator::isOfflineLanguageDetectionEnabled() const
+{
+    return m_offlineLanguageDetectionEnabled;
+}
+
+void QOnlineTranslator::setOfflineLanguageDetectionEnabled(bool enable)
+{
+    m_offlineLanguageDetectionEnabled = enable;
+}
+
+bool QOnlineTranslator::isLazyDictionaryEnabled() const
+{
+    return m_lazyDictionaryEnabled;
+}
+
+void QOnlineTranslator::setLazyDictionaryEnabled(bool enable)
+{
+    m_lazyDictionaryEnabled = enable;
+}
+
 void QOnlineTranslator::setEngineUrl(Engine engine, QString url)
 {
     switch (engine) {
+    case Google:
+        m_googleUrl = url.isEmpty() ? s_googleUrl : qMove(url);
+        break;
+    case Yandex:
+        // Yandex uses a separate host for dictionary, but a custom URL should serve both
+        m_yandexDictionaryUrl = url.isEmpty() ? s_yandexDictionaryUrl : url;
+        m_yandexUrl = url.isEmpty() ? s_yandexUrl : qMove(url);
+        break;
+    case Bing:
+        m_bingUrl = url.isEmpty() ? s_bingUrl : qMove(url);
+        break;
     case LibreTranslate:
         m_libreUrl = qMove(url);
         break;
@@ -462,6 +838,41 @@ void QOnlineTranslator::setEngineUrl(Engine engine, QString url)
     }
 }
 
+QNetworkAccessManager *QOnlineTranslator::networkAccessManager() const
+{
+    return m_networkManager;
+}
+
+void QOnlineTranslator::setNetworkAccessManager(QNetworkAccessManager *manager)
+{
+    if (manager == m_networkManager)
+        return;
+
+    if (m_networkManager->parent() == this)
+        m_networkManager->deleteLater();
+    m_networkManager = manager != nullptr ? manager : new QNetworkAccessManager(this);
+}
+
+QTranslationTracer *QOnlineTranslator::tracer() const
+{
+    return m_tracer;
+}
+
+void QOnlineTranslator::setTracer(QTranslationTracer *tracer)
+{
+    m_tracer = tracer;
+}
+
+QDictionaryCache *QOnlineTranslator::dictionaryCache() const
+{
+    return m_dictionaryCache;
+}
+
+void QOnlineTranslator::setDictionaryCache(QDictionaryCache *cache)
+{
+    m_dictionaryCache = cache;
+}
+
 void QOnlineTranslator::setEngineApiKey(Engine engine, QByteArray apiKey)
 {
     switch (engine) {
@@ -735,7 +1146,7 @@ QString QOnlineTranslator::languageName(Language lang)
 
 QString QOnlineTranslator::languageCode(Language lang)
 {
-    return s_genericLanguageCodes.value(lang);
+    return findLanguageCode(s_genericLanguageCodesTable, lang);
 }
 
 QOnlineTranslator::Language QOnlineTranslator::language(const QLocale &locale)
@@ -953,278 +1364,31 @@ QOnlineTranslator::Language QOnlineTranslator::language(const QLocale &locale)
 // Returns general language code
 QOnlineTranslator::Language QOnlineTranslator::language(const QString &langCode)
 {
-    return s_genericLanguageCodes.key(langCode, NoLanguage);
+    return findLanguage(s_genericLanguageCodesTable, langCode);
 }
 
 bool QOnlineTranslator::isSupportTranslation(Engine engine, Language lang)
 {
-    bool isSupported = false;
+    return s_translationLanguages[engine].contains(lang);
+}
 
-    switch (engine) {
-    case Google:
-    case Lingva: // Lingva is a frontend to Google Translate
-        switch (lang) {
-        case NoLanguage:
-        case Bashkir:
-        case Cantonese:
-        case Fijian:
-        case Filipino:
-        case Georgian:
-        case HillMari:
-        case Klingon:
-        case KlingonPlqaD:
-        case LevantineArabic:
-        case Mari:
-        case Papiamento:
-        case QueretaroOtomi:
-        case SerbianLatin:
-        case Tahitian:
-        case Tongan:
-        case Udmurt:
-        case YucatecMaya:
-            isSupported = false;
-            break;
-        default:
-            isSupported = true;
-            break;
-        }
-        break;
-    case Yandex:
-        switch (lang) {
-        case NoLanguage:
-        case Cantonese:
-        case Chichewa:
-        case Corsican:
-        case Fijian:
-        case Filipino:
-        case Frisian:
-        case Hausa:
-        case Hawaiian:
-        case Igbo:
-        case Kinyarwanda:
-        case Klingon:
-        case KlingonPlqaD:
-        case Kurdish:
-        case LevantineArabic:
-        case Oriya:
-        case Pashto:
-        case QueretaroOtomi:
-        case Samoan:
-        case SerbianLatin:
-        case Sesotho:
-        case Shona:
-        case Sindhi:
-        case Somali:
-        case Tahitian:
-        case Tongan:
-        case Turkmen:
-        case Uighur:
-        case Yoruba:
-        case YucatecMaya:
-        case Zulu:
-            isSupported = false;
-            break;
-        default:
-            isSupported = true;
-            break;
-        }
-        break;
-    case Bing:
-        switch (lang) {
-        case NoLanguage:
-        case Albanian:
-        case Amharic:
-        case Armenian:
-        case Azerbaijani:
-        case Basque:
-        case Bashkir:
-        case Belarusian:
-        case Cebuano:
-        case Corsican:
-        case Esperanto:
-        case Frisian:
-        case Galician:
-        case Georgian:
-        case Gujarati:
-        case Hausa:
-        case Hawaiian:
-        case HillMari:
-        case Igbo:
-        case Irish:
-        case Javanese:
-        case Kannada:
-        case Kazakh:
-        case Khmer:
-        case Kinyarwanda:
-        case Kurdish:
-        case Kyrgyz:
-        case Lao:
-        case Latin:
-        case Luxembourgish:
-        case Macedonian:
-        case Malayalam:
-        case Maori:
-        case Marathi:
-        case Mari:
-        case Mongolian:
-        case Myanmar:
-        case Nepali:
-        case Oriya:
-        case Chichewa:
-        case Papiamento:
-        case Pashto:
-        case Punjabi:
-        case ScotsGaelic:
-        case Sesotho:
-        case Shona:
-        case Sindhi:
-        case Sinhala:
-        case Somali:
-        case Sundanese:
-        case Tagalog:
-        case Tajik:
-        case Tatar:
-        case Turkmen:
-        case Uighur:
-        case Udmurt:
-        case Uzbek:
-        case Xhosa:
-        case Yiddish:
-        case Yoruba:
-        case Zulu:
-            isSupported = false;
-            break;
-        default:
-            isSupported = true;
-            break;
-        }
-        break;
-    case LibreTranslate:
-        switch (lang) {
-        case NoLanguage:
-        case Afrikaans:
-        case Albanian:
-        case Amharic:
-        case Armenian:
-        case Azerbaijani:
-        case Bashkir:
-        case Basque:
-        case Belarusian:
-        case Bengali:
-        case Bosnian:
-        case Bulgarian:
-        case Cantonese:
-        case Catalan:
-        case Cebuano:
-        case Chichewa:
-        case Corsican:
-        case Croatian:
-        case Czech:
-        case Danish:
-        case Dutch:
-        case Esperanto:
-        case Estonian:
-        case Fijian:
-        case Filipino:
-        case Finnish:
-        case Frisian:
-        case Galician:
-        case Georgian:
-        case Greek:
-        case Gujarati:
-        case HaitianCreole:
-        case Hausa:
-        case Hawaiian:
-        case Hebrew:
-        case HillMari:
-        case Hmong:
-        case Hungarian:
-        case Icelandic:
-        case Igbo:
-        case Javanese:
-        case Kannada:
-        case Kazakh:
-        case Khmer:
-        case Kinyarwanda:
-        case Klingon:
-        case KlingonPlqaD:
-        case Kurdish:
-        case Kyrgyz:
-        case Lao:
-        case Latin:
-        case Latvian:
-        case LevantineArabic:
-        case Lithuanian:
-        case Luxembourgish:
-        case Macedonian:
-        case Malagasy:
-        case Malay:
-        case Malayalam:
-        case Maltese:
-        case Maori:
-        case Marathi:
-        case Mari:
-        case Mongolian:
-        case Myanmar:
-        case Nepali:
-        case Norwegian:
-        case Oriya:
-        case Papiamento:
-        case Pashto:
-        case Persian:
-        case Punjabi:
-        case QueretaroOtomi:
-        case Romanian:
-        case Samoan:
-        case ScotsGaelic:
-        case SerbianCyrillic:
-        case SerbianLatin:
-        case Sesotho:
-        case Shona:
-        case SimplifiedChinese:
-        case Sindhi:
-        case Sinhala:
-        case Slovak:
-        case Slovenian:
-        case Somali:
-        case Sundanese:
-        case Swahili:
-        case Swedish:
-        case Tagalog:
-        case Tahitian:
-        case Tajik:
-        case Tamil:
-        case Tatar:
-        case Telugu:
-        case Thai:
-        case Tongan:
-        case Turkmen:
-        case Udmurt:
-        case Uighur:
-        case Ukrainian:
-        case Urdu:
-        case Uzbek:
-        case Welsh:
-        case Xhosa:
-        case Yiddish:
-        case Yoruba:
-        case YucatecMaya:
-        case Zulu:
-            isSupported = false;
-            break;
-        default:
-            isSupported = true;
-            break;
-        }
-        break;
+QVector<QOnlineTranslator::Language> QOnlineTranslator::supportedLanguages(Engine engine)
+{
+    QVector<Language> languages;
+    languages.reserve(static_cast<int>(s_languagesCount));
+    const LanguageSet &supported = s_translationLanguages[engine];
+    for (int lang = Auto; lang <= Zulu; ++lang) {
+        if (supported.contains(static_cast<Language>(lang)))
+            languages.append(static_cast<Language>(lang));
     }
-
-    return isSupported;
+    return languages;
 }
 
 void QOnlineTranslator::skipGarbageText()
 {
-    m_translation.append(sender()->property(s_textProperty).toString());
+    // Separate from the translated parts the same way as the engines parts
+    addSpaceBetweenParts(m_result->translation);
+    m_result->translation += sender()->property(s_textProperty).toString().trimmed();
 }
 
 void QOnlineTranslator::requestGoogleTranslate()
@@ -1232,11 +1396,43 @@ void QOnlineTranslator::requestGoogleTranslate()
     const QString sourceText = sender()->property(s_textProperty).toString();
 
     // Generate API url
-    QUrl url(QStringLiteral("https://translate.googleapis.com/translate_a/single"));
-    url.setQuery(QStringLiteral("client=gtx&ie=UTF-8&oe=UTF-8&dt=bd&dt=ex&dt=ld&dt=md&dt=rw&dt=rm&dt=ss&dt=t&dt=at&dt=qc&sl=%1&tl=%2&hl=%3&q=%4")
-                     .arg(languageApiCode(Google, m_sourceLang), languageApiCode(Google, m_translationLang), languageApiCode(Google, m_uiLang), QUrl::toPercentEncoding(sourceText)));
+    QUrl url(m_googleUrl + "/translate_a/single");
+    url.setQuery(QStringLiteral("client=gtx&ie=UTF-8&oe=UTF-8&%1&sl=%2&tl=%3&hl=%4")
+                     .arg(googleSections(), languageApiCode(Google, m_result->sourceLang), languageApiCode(Google, m_result->translationLang), languageApiCode(Google, m_uiLang)));
 
-    m_currentReply = m_networkManager->get(QNetworkRequest(url));
+    // Send text as POST data to not depend on the URL length limit
+    QByteArray postData = "q=";
+    QPercentEncoder::append(postData, sourceText);
+
+    // Setup request
+    QNetworkRequest request;
+    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/x-www-form-urlencoded");
+    request.setUrl(url);
+
+    // Make reply
+    m_currentReply = m_networkManager->post(request, postData);
+}
+
+// Request only the response sections that parseGoogleTranslate() reads
+// (t - translation, rm - transliteration, bd - translation options, md - examples)
+QString QOnlineTranslator::googleSections() const
+{
+    QString sections = QStringLiteral("dt=t");
+    if (m_onlyDetectLanguage)
+        return sections;
+
+    if (m_sourceTranslitEnabled || m_translationTranslitEnabled)
+        sections += QLatin1String("&dt=rm");
+
+    // Dictionary data is not parsed for the long texts
+    if (m_result->source.size() < s_googleTranslateLimit) {
+        if (m_translationOptionsEnabled)
+            sections += QLatin1String("&dt=bd");
+        if (m_examplesEnabled)
+            sections += QLatin1String("&dt=md");
+    }
+
+    return sections;
 }
 
 void QOnlineTranslator::parseGoogleTranslate()
@@ -1263,10 +1459,10 @@ void QOnlineTranslator::parseGoogleTranslate()
     const QJsonDocument jsonResponse = QJsonDocument::fromJson(data);
     const QJsonArray jsonData = jsonResponse.array();
 
-    if (m_sourceLang == Auto) {
+    if (m_result->sourceLang == Auto) {
         // Parse language
-        m_sourceLang = language(Google, jsonData.at(2).toString());
-        if (m_sourceLang == NoLanguage) {
+        m_result->sourceLang = language(Google, jsonData.at(2).toString());
+        if (m_result->sourceLang == NoLanguage) {
             resetData(ParsingError, tr("Error: Unable to parse autodetected language"));
             return;
         }
@@ -1274,27 +1470,30 @@ void QOnlineTranslator::parseGoogleTranslate()
             return;
     }
 
-    addSpaceBetweenParts(m_translation);
-    addSpaceBetweenParts(m_translationTranslit);
-    addSpaceBetweenParts(m_sourceTranslit);
-    for (const QJsonValueRef translationData : jsonData.at(0).toArray()) {
+    addSpaceBetweenParts(m_result->translation);
+    addSpaceBetweenParts(m_result->translationTranslit);
+    addSpaceBetweenParts(m_result->sourceTranslit);
+    const QJsonArray translationsData = jsonData.at(0).toArray();
+    for (const QJsonValue &translationData : translationsData) {
         const QJsonArray translationArray = translationData.toArray();
-        m_translation.append(translationArray.at(0).toString());
+        m_result->translation.append(translationArray.at(0).toString());
         if (m_translationTranslitEnabled)
-            m_translationTranslit.append(translationArray.at(2).toString());
+            m_result->translationTranslit.append(translationArray.at(2).toString());
         if (m_sourceTranslitEnabled)
-            m_sourceTranslit.append(translationArray.at(3).toString());
+            m_result->sourceTranslit.append(translationArray.at(3).toString());
     }
 
-    if (m_source.size() >= s_googleTranslateLimit)
+    if (m_result->source.size() >= s_googleTranslateLimit)
         return;
 
     // Translation options
     if (m_translationOptionsEnabled) {
-        for (const QJsonValueRef typeOfSpeechData : jsonData.at(1).toArray()) {
+        const QJsonArray optionsData = jsonData.at(1).toArray();
+        for (const QJsonValue &typeOfSpeechData : optionsData) {
             const QJsonArray typeOfSpeechDataArray = typeOfSpeechData.toArray();
             const QString typeOfSpeech = typeOfSpeechDataArray.at(0).toString();
-            for (const QJsonValueRef wordData : typeOfSpeechDataArray.at(2).toArray()) {
+            const QJsonArray wordsData = typeOfSpeechDataArray.at(2).toArray();
+            for (const QJsonValue &wordData : wordsData) {
                 const QJsonArray wordDataArray = wordData.toArray();
                 const QString word = wordDataArray.at(0).toString();
                 const QString gender = wordDataArray.at(4).toString();
@@ -1303,23 +1502,25 @@ void QOnlineTranslator::parseGoogleTranslate()
                 translations.reserve(translationsArray.size());
                 for (const QJsonValue &wordTranslation : translationsArray)
                     translations.append(wordTranslation.toString());
-                m_translationOptions[typeOfSpeech].append({word, gender, translations});
+                m_result->translationOptions[typeOfSpeech].append({word, gender, translations});
             }
         }
     }
 
     // Examples
     if (m_examplesEnabled) {
-        for (const QJsonValueRef examplesData : jsonData.at(12).toArray()) {
+        const QJsonArray allExamplesData = jsonData.at(12).toArray();
+        for (const QJsonValue &examplesData : allExamplesData) {
             const QJsonArray examplesDataArray = examplesData.toArray();
             const QString typeOfSpeech = examplesDataArray.at(0).toString();
 
-            for (const QJsonValueRef exampleData : examplesDataArray.at(1).toArray()) {
+            const QJsonArray exampleDataArray = examplesDataArray.at(1).toArray();
+            for (const QJsonValue &exampleData : exampleDataArray) {
                 const QJsonArray exampleArray = exampleData.toArray();
                 const QString example = exampleArray.at(2).toString();
                 const QString definition = exampleArray.at(0).toString();
 
-                m_examples[typeOfSpeech].append({example, definition});
+                m_result->examples[typeOfSpeech].append({example, definition});
             }
         }
     }
@@ -1330,20 +1531,20 @@ void QOnlineTranslator::requestYandexTranslate()
     const QString sourceText = sender()->property(s_textProperty).toString();
 
     QString lang;
-    if (m_sourceLang == Auto)
-        lang = languageApiCode(Yandex, m_translationLang);
+    if (m_result->sourceLang == Auto)
+        lang = languageApiCode(Yandex, m_result->translationLang);
     else
-        lang = languageApiCode(Yandex, m_sourceLang) + '-' + languageApiCode(Yandex, m_translationLang);
+        lang = languageApiCode(Yandex, m_result->sourceLang) + '-' + languageApiCode(Yandex, m_result->translationLang);
 
     // Generate API url
-    QUrl url(QStringLiteral("https://translate.yandex.net/api/v1/tr.json/translate"));
-    url.setQuery(QStringLiteral("ucid=%1&srv=android&text=%2&lang=%3")
-                     .arg(s_yandexUcid, QUrl::toPercentEncoding(sourceText), lang));
+    QByteArray url = m_yandexUrl.toUtf8() + "/api/v1/tr.json/translate?ucid=" + yandexUcid() + "&srv=android&text=";
+    QPercentEncoder::append(url, sourceText);
+    url += "&lang=" + lang.toUtf8();
 
     // Setup request
     QNetworkRequest request;
     request.setHeader(QNetworkRequest::ContentTypeHeader, "application/x-www-form-urlencoded");
-    request.setUrl(url);
+    request.setUrl(QUrl::fromEncoded(url));
 
     // Make reply
     m_currentReply = m_networkManager->post(request, QByteArray());
@@ -1373,11 +1574,11 @@ void QOnlineTranslator::parseYandexTranslate()
     const QJsonObject jsonData = jsonResponse.object();
 
     // Parse language
-    if (m_sourceLang == Auto) {
+    if (m_result->sourceLang == Auto) {
         QString sourceCode = jsonData.value(QStringLiteral("lang")).toString();
         sourceCode = sourceCode.left(sourceCode.indexOf('-'));
-        m_sourceLang = language(Yandex, sourceCode);
-        if (m_sourceLang == NoLanguage) {
+        m_result->sourceLang = language(Yandex, sourceCode);
+        if (m_result->sourceLang == NoLanguage) {
             resetData(ParsingError, tr("Error: Unable to parse autodetected language"));
             return;
         }
@@ -1386,33 +1587,33 @@ void QOnlineTranslator::parseYandexTranslate()
     }
 
     // Parse translation data
-    m_translation += jsonData.value(QStringLiteral("text")).toArray().at(0).toString();
+    m_result->translation += jsonData.value(QStringLiteral("text")).toArray().at(0).toString();
 }
 
 void QOnlineTranslator::requestYandexSourceTranslit()
 {
-    requestYandexTranslit(m_sourceLang);
+    requestYandexTranslit(m_result->sourceLang, m_result->sourceTranslit);
 }
 
 void QOnlineTranslator::parseYandexSourceTranslit()
 {
-    parseYandexTranslit(m_sourceTranslit);
+    parseYandexTranslit(m_result->sourceTranslit);
 }
 
 void QOnlineTranslator::requestYandexTranslationTranslit()
 {
-    requestYandexTranslit(m_translationLang);
+    requestYandexTranslit(m_result->translationLang, m_result->translationTranslit);
 }
 
 void QOnlineTranslator::parseYandexTranslationTranslit()
 {
-    parseYandexTranslit(m_translationTranslit);
+    parseYandexTranslit(m_result->translationTranslit);
 }
 
 void QOnlineTranslator::requestYandexDictionary()
 {
-    // Check if language is supported (need to check here because language may be autodetected)
-    if (!isSupportDictionary(Yandex, m_sourceLang, m_translationLang) && !m_source.contains(' ')) {
+    // Check if language is supported (need to check here because language may be autodetected), cached dictionary doesn't need the request
+    if ((!isSupportDictionary(Yandex, m_result->sourceLang, m_result->translationLang) && !m_result->source.contains(' ')) || applyCachedDictionary()) {
         auto *state = qobject_cast<QState *>(sender());
         state->addTransition(new QFinalState(state->parentState()));
         return;
@@ -1420,11 +1621,13 @@ void QOnlineTranslator::requestYandexDictionary()
 
     // Generate API url
     const QString text = sender()->property(s_textProperty).toString();
-    QUrl url(QStringLiteral("https://dictionary.yandex.net/dicservice.json/lookupMultiple"));
-    url.setQuery(QStringLiteral("text=%1&ui=%2&dict=%3-%4")
-                     .arg(QUrl::toPercentEncoding(text), languageApiCode(Yandex, m_uiLang), languageApiCode(Yandex, m_sourceLang), languageApiCode(Yandex, m_translationLang)));
+    QByteArray url = m_yandexDictionaryUrl.toUtf8() + "/dicservice.json/lookupMultiple?text=";
+    QPercentEncoder::append(url, text);
+    url += QStringLiteral("&ui=%1&dict=%2-%3")
+               .arg(languageApiCode(Yandex, m_uiLang), languageApiCode(Yandex, m_result->sourceLang), languageApiCode(Yandex, m_result->translationLang))
+               .toUtf8();
 
-    m_currentReply = m_networkManager->get(QNetworkRequest(url));
+    m_currentReply = m_networkManager->get(QNetworkRequest(QUrl::fromEncoded(url)));
 }
 
 void QOnlineTranslator::parseYandexDictionary()
@@ -1432,21 +1635,23 @@ void QOnlineTranslator::parseYandexDictionary()
     m_currentReply->deleteLater();
 
     if (m_currentReply->error() != QNetworkReply::NoError) {
-        resetData(NetworkError, m_currentReply->errorString());
+        setDictionaryError(m_currentReply->errorString());
         return;
     }
 
     // Parse reply
     const QJsonDocument jsonResponse = QJsonDocument::fromJson(m_currentReply->readAll());
-    const QJsonValue jsonData = jsonResponse.object().value(languageApiCode(Yandex, m_sourceLang) + '-' + languageApiCode(Yandex, m_translationLang)).toObject().value(QStringLiteral("regular"));
-
-    if (m_sourceTranscriptionEnabled)
-        m_sourceTranscription = jsonData.toArray().at(0).toObject().value(QStringLiteral("ts")).toString();
-
-    for (const QJsonValueRef typeOfSpeechData : jsonData.toArray()) {
-        QJsonObject typeOfSpeechObject = typeOfSpeechData.toObject();
+    const QJsonArray jsonData = jsonResponse.object().value(languageApiCode(Yandex, m_result->sourceLang) + '-' + languageApiCode(Yandex, m_result->translationLang)).toObject().value(QStringLiteral("regular")).toArray();
+
+    // Examples and transcription are always parsed to be cached
+    QMap<QString, QVector<QOption>> translationOptions;
+    QMap<QString, QVector<QExample>> examples;
+    const QString transcription = jsonData.at(0).toObject().value(QStringLiteral("ts")).toString();
+    for (const QJsonValue &typeOfSpeechData : jsonData) {
+        const QJsonObject typeOfSpeechObject = typeOfSpeechData.toObject();
         const QString typeOfSpeech = typeOfSpeechObject.value(QStringLiteral("pos")).toObject().value(QStringLiteral("text")).toString();
-        for (const QJsonValueRef wordData : typeOfSpeechObject.value(QStringLiteral("tr")).toArray()) {
+        const QJsonArray wordsData = typeOfSpeechObject.value(QStringLiteral("tr")).toArray();
+        for (const QJsonValue &wordData : wordsData) {
             // Parse translation options
             const QJsonObject wordObject = wordData.toObject();
             const QString word = wordObject.value(QStringLiteral("text")).toString();
@@ -1457,25 +1662,28 @@ void QOnlineTranslator::parseYandexDictionary()
             for (const QJsonValue &wordTranslation : translationsArray)
                 translations.append(wordTranslation.toObject().value(QStringLiteral("text")).toString());
 
-            m_translationOptions[typeOfSpeech].append({word, gender, translations});
+            translationOptions[typeOfSpeech].append({word, gender, translations});
 
             // Parse examples
-            if (m_examplesEnabled && wordObject.contains(QLatin1String("ex"))) {
-                for (const QJsonValueRef exampleData : wordObject.value(QStringLiteral("ex")).toArray()) {
-                    const QJsonObject exampleObject = exampleData.toObject();
-                    const QString example = exampleObject.value(QStringLiteral("text")).toString();
-                    const QString description = exampleObject.value(QStringLiteral("tr")).toArray().first().toObject().value(QStringLiteral("text")).toString();
-
-                    m_examples[typeOfSpeech].append({example, description});
-                }
+            const QJsonArray examplesData = wordObject.value(QStringLiteral("ex")).toArray();
+            for (const QJsonValue &exampleData : examplesData) {
+                const QJsonObject exampleObject = exampleData.toObject();
+                const QString example = exampleObject.value(QStringLiteral("text")).toString();
+                const QString description = exampleObject.value(QStringLiteral("tr")).toArray().at(0).toObject().value(QStringLiteral("text")).toString();
+
+                examples[typeOfSpeech].append({example, description});
             }
         }
     }
+
+    if (m_dictionaryCache != nullptr)
+        m_dictionaryCache->insert(Yandex, m_result->sourceLang, m_result->translationLang, m_uiLang, m_result->source, {translationOptions, examples, transcription});
+    applyDictionary(translationOptions, examples, transcription);
 }
 
 void QOnlineTranslator::requestBingCredentials()
 {
-    const QUrl url(QStringLiteral("https://www.bing.com/translator"));
+    const QUrl url(m_bingUrl + "/translator");
     m_currentReply = m_networkManager->get(QNetworkRequest(url));
 }
 
@@ -1541,13 +1749,14 @@ void QOnlineTranslator::requestBingTranslate()
     const QString sourceText = sender()->property(s_textProperty).toString();
 
     // Generate POST data
-    const QByteArray postData = "&text=" + QUrl::toPercentEncoding(sourceText)
-        + "&fromLang=" + languageApiCode(Bing, m_sourceLang).toUtf8()
-        + "&to=" + languageApiCode(Bing, m_translationLang).toUtf8()
+    QByteArray postData = "&text=";
+    QPercentEncoder::append(postData, sourceText);
+    postData += "&fromLang=" + languageApiCode(Bing, m_result->sourceLang).toUtf8()
+        + "&to=" + languageApiCode(Bing, m_result->translationLang).toUtf8()
         + "&token=" + s_bingToken
         + "&key=" + s_bingKey;
 
-    QUrl url(QStringLiteral("https://www.bing.com/ttranslatev3"));
+    QUrl url(m_bingUrl + "/ttranslatev3");
     url.setQuery(QStringLiteral("IG=%1&IID=%2").arg(s_bingIg, s_bingIid));
 
     // Setup request
@@ -1574,10 +1783,10 @@ void QOnlineTranslator::parseBingTranslate()
     const QJsonDocument jsonResponse = QJsonDocument::fromJson(m_currentReply->readAll());
     const QJsonObject responseObject = jsonResponse.array().first().toObject();
 
-    if (m_sourceLang == Auto) {
+    if (m_result->sourceLang == Auto) {
         const QString langCode = responseObject.value(QStringLiteral("detectedLanguage")).toObject().value(QStringLiteral("language")).toString();
-        m_sourceLang = language(Bing, langCode);
-        if (m_sourceLang == NoLanguage) {
+        m_result->sourceLang = language(Bing, langCode);
+        if (m_result->sourceLang == NoLanguage) {
             resetData(ParsingError, tr("Error: Unable to parse autodetected language"));
             return;
         }
@@ -1586,27 +1795,29 @@ void QOnlineTranslator::parseBingTranslate()
     }
 
     const QJsonObject translationsObject = responseObject.value(QStringLiteral("translations")).toArray().first().toObject();
-    m_translation += translationsObject.value(QStringLiteral("text")).toString();
-    m_translationTranslit += translationsObject.value(QStringLiteral("transliteration")).toObject().value(QStringLiteral("text")).toString();
+    m_result->translation += translationsObject.value(QStringLiteral("text")).toString();
+    if (m_translationTranslitEnabled)
+        m_result->translationTranslit += translationsObject.value(QStringLiteral("transliteration")).toObject().value(QStringLiteral("text")).toString();
 }
 
 void QOnlineTranslator::requestBingDictionary()
 {
-    // Check if language is supported (need to check here because language may be autodetected)
-    if (!isSupportDictionary(Bing, m_sourceLang, m_translationLang) && !m_source.contains(' ')) {
+    // Check if language is supported (need to check here because language may be autodetected), cached dictionary doesn't need the request
+    if ((!isSupportDictionary(Bing, m_result->sourceLang, m_result->translationLang) && !m_result->source.contains(' ')) || applyCachedDictionary()) {
         auto *state = qobject_cast<QState *>(sender());
         state->addTransition(new QFinalState(state->parentState()));
         return;
     }
 
     // Generate POST data
-    const QByteArray postData = "&text=" + QUrl::toPercentEncoding(sender()->property(s_textProperty).toString())
-        + "&from=" + languageApiCode(Bing, m_sourceLang).toUtf8()
-        + "&to=" + languageApiCode(Bing, m_translationLang).toUtf8();
+    QByteArray postData = "&text=";
+    QPercentEncoder::append(postData, sender()->property(s_textProperty).toString());
+    postData += "&from=" + languageApiCode(Bing, m_result->sourceLang).toUtf8()
+        + "&to=" + languageApiCode(Bing, m_result->translationLang).toUtf8();
 
     QNetworkRequest request;
     request.setHeader(QNetworkRequest::ContentTypeHeader, "application/x-www-form-urlencoded");
-    request.setUrl(QStringLiteral("https://www.bing.com/tlookupv3"));
+    request.setUrl(m_bingUrl + "/tlookupv3");
 
     m_currentReply = m_networkManager->post(request, postData);
 }
@@ -1617,14 +1828,16 @@ void QOnlineTranslator::parseBingDictionary()
 
     // Check for errors
     if (m_currentReply->error() != QNetworkReply::NoError) {
-        resetData(NetworkError, m_currentReply->errorString());
+        setDictionaryError(m_currentReply->errorString());
         return;
     }
 
     const QJsonDocument jsonResponse = QJsonDocument::fromJson(m_currentReply->readAll());
     const QJsonObject responseObject = jsonResponse.array().first().toObject();
 
-    for (const QJsonValueRef dictionaryData : responseObject.value(QStringLiteral("translations")).toArray()) {
+    QMap<QString, QVector<QOption>> translationOptions;
+    const QJsonArray dictionariesData = responseObject.value(QStringLiteral("translations")).toArray();
+    for (const QJsonValue &dictionaryData : dictionariesData) {
         const QJsonObject dictionaryObject = dictionaryData.toObject();
         const QString typeOfSpeech = dictionaryObject.value(QStringLiteral("posTag")).toString().toLower();
         const QString word = dictionaryObject.value(QStringLiteral("displayTarget")).toString().toLower();
@@ -1634,8 +1847,12 @@ void QOnlineTranslator::parseBingDictionary()
         for (const QJsonValue &wordTranslation : translationsArray)
             translations.append(wordTranslation.toObject().value(QStringLiteral("displayText")).toString());
 
-        m_translationOptions[typeOfSpeech].append({word, {}, translations});
+        translationOptions[typeOfSpeech].append({word, {}, translations});
     }
+
+    if (m_dictionaryCache != nullptr)
+        m_dictionaryCache->insert(Bing, m_result->sourceLang, m_result->translationLang, m_uiLang, m_result->source, {translationOptions, {}, {}});
+    applyDictionary(translationOptions, {}, {});
 }
 
 void QOnlineTranslator::requestLibreLangDetection()
@@ -1643,8 +1860,9 @@ void QOnlineTranslator::requestLibreLangDetection()
     const QString sourceText = sender()->property(s_textProperty).toString();
 
     // Generate POST data
-    const QByteArray postData = "&q=" + QUrl::toPercentEncoding(sourceText)
-        + "&api_key=" + m_libreApiKey;
+    QByteArray postData = "&q=";
+    QPercentEncoder::append(postData, sourceText);
+    postData += "&api_key=" + m_libreApiKey;
 
     // Setup request
     QNetworkRequest request;
@@ -1668,10 +1886,10 @@ void QOnlineTranslator::parseLibreLangDetection()
     const QJsonDocument jsonResponse = QJsonDocument::fromJson(m_currentReply->readAll());
     const QJsonObject responseObject = jsonResponse.array().first().toObject();
 
-    if (m_sourceLang == Auto) {
+    if (m_result->sourceLang == Auto) {
         const QString langCode = responseObject.value(QStringLiteral("language")).toString();
-        m_sourceLang = language(LibreTranslate, langCode);
-        if (m_sourceLang == NoLanguage) {
+        m_result->sourceLang = language(LibreTranslate, langCode);
+        if (m_result->sourceLang == NoLanguage) {
             resetData(ParsingError, tr("Error: Unable to parse autodetected language"));
         }
     }
@@ -1682,9 +1900,10 @@ void QOnlineTranslator::requestLibreTranslate()
     const QString sourceText = sender()->property(s_textProperty).toString();
 
     // Generate POST data
-    const QByteArray postData = "&q=" + QUrl::toPercentEncoding(sourceText)
-        + "&source=" + languageApiCode(LibreTranslate, m_sourceLang).toUtf8()
-        + "&target=" + languageApiCode(LibreTranslate, m_translationLang).toUtf8()
+    QByteArray postData = "&q=";
+    QPercentEncoder::append(postData, sourceText);
+    postData += "&source=" + languageApiCode(LibreTranslate, m_result->sourceLang).toUtf8()
+        + "&target=" + languageApiCode(LibreTranslate, m_result->translationLang).toUtf8()
         + "&api_key=" + m_libreApiKey;
 
     // Setup request
@@ -1709,7 +1928,9 @@ void QOnlineTranslator::parseLibreTranslate()
     const QJsonDocument jsonResponse = QJsonDocument::fromJson(m_currentReply->readAll());
     const QJsonObject responseObject = jsonResponse.object();
 
-    m_translation = responseObject.value(QStringLiteral("translatedText")).toString();
+    // Text may be split into several parts
+    addSpaceBetweenParts(m_result->translation);
+    m_result->translation += responseObject.value(QStringLiteral("translatedText")).toString();
 }
 
 void QOnlineTranslator::requestLingvaTranslate()
@@ -1717,12 +1938,13 @@ void QOnlineTranslator::requestLingvaTranslate()
     const QString sourceText = sender()->property(s_textProperty).toString();
 
     // Generate API url
-    QUrl url(m_lingvaUrl + "/api/v1/"
-             + languageApiCode(Lingva, m_sourceLang) + "/"
-             + languageApiCode(Lingva, m_translationLang) + "/"
-             + QUrl::toPercentEncoding(sourceText));
+    QByteArray url = QString(m_lingvaUrl + "/api/v1/"
+                             + languageApiCode(Lingva, m_result->sourceLang) + "/"
+                             + languageApiCode(Lingva, m_result->translationLang) + "/")
+                         .toUtf8();
+    QPercentEncoder::append(url, sourceText);
 
-    m_currentReply = m_networkManager->get(QNetworkRequest(url));
+    m_currentReply = m_networkManager->get(QNetworkRequest(QUrl::fromEncoded(url)));
 }
 
 void QOnlineTranslator::parseLingvaTranslate()
@@ -1738,21 +1960,30 @@ void QOnlineTranslator::parseLingvaTranslate()
     // Parse translation data
     const QJsonDocument jsonResponse = QJsonDocument::fromJson(m_currentReply->readAll());
     const QJsonObject responseObject = jsonResponse.object();
-    const QJsonObject jsonData = responseObject.value(QStringLiteral("info")).toObject();
 
-    // Parse translation itself
-    m_translation = responseObject.value(QStringLiteral("translation")).toString();
+    // Parse translation itself, text may be split into several parts
+    addSpaceBetweenParts(m_result->translation);
+    m_result->translation += responseObject.value(QStringLiteral("translation")).toString();
+
+    // Additional info is needed only for the enabled data
+    if (!m_translationTranslitEnabled && !m_translationOptionsEnabled && !m_examplesEnabled)
+        return;
+
+    const QJsonObject jsonData = responseObject.value(QStringLiteral("info")).toObject();
 
     // Parse transliteration, if enabled
-    if (m_translationTranslitEnabled)
-        m_translationTranslit = jsonData.value(QStringLiteral("pronunciation"))
-                                    .toObject()
-                                    .value(QStringLiteral("translation"))
-                                    .toString();
+    if (m_translationTranslitEnabled) {
+        addSpaceBetweenParts(m_result->translationTranslit);
+        m_result->translationTranslit += jsonData.value(QStringLiteral("pronunciation"))
+                                     .toObject()
+                                     .value(QStringLiteral("translation"))
+                                     .toString();
+    }
 
     // Translation options
     if (m_translationOptionsEnabled) {
-        for (const QJsonValueRef typeOfSpeechData : jsonData.value(QStringLiteral("extraTranslations")).toArray()) {
+        const QJsonArray optionsData = jsonData.value(QStringLiteral("extraTranslations")).toArray();
+        for (const QJsonValue &typeOfSpeechData : optionsData) {
             const QJsonObject speechDataObject = typeOfSpeechData.toObject();
             const QJsonArray typeOfSpeechDataArray = speechDataObject.value(QStringLiteral("list")).toArray();
             const QString typeOfSpeech = speechDataObject.value(QStringLiteral("type")).toString();
@@ -1764,28 +1995,51 @@ void QOnlineTranslator::parseLingvaTranslate()
                 translations.reserve(translationsArray.size());
                 for (const QJsonValue &wordTranslation : translationsArray)
                     translations.append(wordTranslation.toString());
-                m_translationOptions[typeOfSpeech].append({word, QString(), translations});
+                m_result->translationOptions[typeOfSpeech].append({word, QString(), translations});
             }
         }
     }
 
     // Examples
     if (m_examplesEnabled) {
-        for (const QJsonValueRef examplesData : jsonData.value(QStringLiteral("definitions")).toArray()) {
+        const QJsonArray allExamplesData = jsonData.value(QStringLiteral("definitions")).toArray();
+        for (const QJsonValue &examplesData : allExamplesData) {
             const QJsonObject examplesObject = examplesData.toObject();
             const QString typeOfSpeech = examplesObject.value(QStringLiteral("type")).toString();
 
-            for (const QJsonValueRef exampleData : examplesObject.value("list").toArray()) {
+            const QJsonArray exampleDataArray = examplesObject.value(QStringLiteral("list")).toArray();
+            for (const QJsonValue &exampleData : exampleDataArray) {
                 const QJsonObject exampleObject = exampleData.toObject();
                 const QString example = exampleObject.value(QStringLiteral("example")).toString();
                 const QString definition = exampleObject.value(QStringLiteral("definition")).toString();
 
-                m_examples[typeOfSpeech].append({example, definition});
+                m_result->examples[typeOfSpeech].append({example, definition});
             }
         }
     }
 }
 
+void QOnlineTranslator::buildTranslationStateMachine()
+{
+    switch (m_result->engine) {
+    case Google:
+        buildGoogleStateMachine();
+        break;
+    case Yandex:
+        buildYandexStateMachine();
+        break;
+    case Bing:
+        buildBingStateMachine();
+        break;
+    case LibreTranslate:
+        buildLibreStateMachine();
+        break;
+    case Lingva:
+        buildLingvaStateMachine();
+        break;
+    }
+}
+
 void QOnlineTranslator::buildGoogleStateMachine()
 {
     // States (Google sends translation, translit and dictionary in one request, that will be splitted into several by the translation limit)
@@ -1796,7 +2050,7 @@ void QOnlineTranslator::buildGoogleStateMachine()
     translationState->addTransition(translationState, &QState::finished, finalState);
 
     // Setup translation state
-    buildSplitNetworkRequest(translationState, &QOnlineTranslator::requestGoogleTranslate, &QOnlineTranslator::parseGoogleTranslate, m_source, s_googleTranslateLimit);
+    buildSplitNetworkRequest(translationState, &QOnlineTranslator::requestGoogleTranslate, &QOnlineTranslator::parseGoogleTranslate, m_result->source, s_googleTranslateLimit);
 }
 
 void QOnlineTranslator::buildGoogleDetectStateMachine()
@@ -1809,7 +2063,7 @@ void QOnlineTranslator::buildGoogleDetectStateMachine()
     detectState->addTransition(detectState, &QState::finished, finalState);
 
     // Setup detect state
-    const QString text = m_source.left(getSplitIndex(m_source, s_googleTranslateLimit));
+    const QString text = m_result->source.left(getSplitIndex(m_result->source, s_googleTranslateLimit));
     buildNetworkRequestState(detectState, &QOnlineTranslator::requestGoogleTranslate, &QOnlineTranslator::parseGoogleTranslate, text);
 }
 
@@ -1830,23 +2084,38 @@ void QOnlineTranslator::buildYandexStateMachine()
     dictionaryState->addTransition(dictionaryState, &QState::finished, finalState);
 
     // Setup translation state
-    buildSplitNetworkRequest(translationState, &QOnlineTranslator::requestYandexTranslate, &QOnlineTranslator::parseYandexTranslate, m_source, s_yandexTranslateLimit);
+    buildSplitNetworkRequest(translationState, &QOnlineTranslator::requestYandexTranslate, &QOnlineTranslator::parseYandexTranslate, m_result->source, s_yandexTranslateLimit);
 
-    // Setup source translit state
-    if (m_sourceTranslitEnabled)
-        buildSplitNetworkRequest(sourceTranslitState, &QOnlineTranslator::requestYandexSourceTranslit, &QOnlineTranslator::parseYandexSourceTranslit, m_source, s_yandexTranslitLimit);
-    else
+    // Setup source translit state (common scripts are transliterated locally)
+    if (!m_sourceTranslitEnabled)
         sourceTranslitState->setInitialState(new QFinalState(sourceTranslitState));
+    else if (QTransliterator::isSupported(m_result->sourceLang))
+        buildTranslitState(sourceTranslitState, &QTranslationResultData::source, &QTranslationResultData::sourceLang, &QTranslationResultData::sourceTranslit);
+    else
+        buildSplitNetworkRequest(sourceTranslitState, &QOnlineTranslator::requestYandexSourceTranslit, &QOnlineTranslator::parseYandexSourceTranslit, m_result->source, s_yandexTranslitLimit);
 
     // Setup translation translit state
-    if (m_translationTranslitEnabled)
-        buildSplitNetworkRequest(translationTranslitState, &QOnlineTranslator::requestYandexTranslationTranslit, &QOnlineTranslator::parseYandexTranslationTranslit, m_translation, s_yandexTranslitLimit);
-    else
+    if (!m_translationTranslitEnabled) {
         translationTranslitState->setInitialState(new QFinalState(translationTranslitState));
+    } else if (QTransliterator::isSupported(m_result->translationLang)) {
+        buildTranslitState(translationTranslitState, &QTranslationResultData::translation, &QTranslationResultData::translationLang, &QTranslationResultData::translationTranslit);
+    } else {
+        // Translation is not received yet, so the requests are split on entering the state
+        auto *splitState = new QState(translationTranslitState);
+        auto *requestsState = new QState(translationTranslitState);
+        translationTranslitState->setInitialState(splitState);
+        splitState->addTransition(requestsState);
+        requestsState->addTransition(requestsState, &QState::finished, new QFinalState(translationTranslitState));
+        connect(splitState, &QState::entered, this, [this, requestsState] {
+            buildSplitNetworkRequest(requestsState, &QOnlineTranslator::requestYandexTranslationTranslit, &QOnlineTranslator::parseYandexTranslationTranslit, m_result->translation, s_yandexTranslitLimit);
+        });
+    }
 
-    // Setup dictionary state
-    if (m_translationOptionsEnabled && !isContainsSpace(m_source))
-        buildNetworkRequestState(dictionaryState, &QOnlineTranslator::requestYandexDictionary, &QOnlineTranslator::parseYandexDictionary, m_source);
+    // Setup dictionary state (requested later by fetchDictionary() in lazy mode)
+    const bool isDictionaryNeeded = m_translationOptionsEnabled && !isContainsSpace(m_result->source);
+    m_dictionaryPending = isDictionaryNeeded && m_lazyDictionaryEnabled && !m_streaming && !m_incremental;
+    if (isDictionaryNeeded && !m_dictionaryPending)
+        buildNetworkRequestState(dictionaryState, &QOnlineTranslator::requestYandexDictionary, &QOnlineTranslator::parseYandexDictionary, m_result->source);
     else
         dictionaryState->setInitialState(new QFinalState(dictionaryState));
 }
@@ -1862,7 +2131,7 @@ void QOnlineTranslator::buildYandexDetectStateMachine()
     detectState->addTransition(detectState, &QState::finished, finalState);
 
     // Setup detect state
-    const QString text = m_source.left(getSplitIndex(m_source, s_yandexTranslateLimit));
+    const QString text = m_result->source.left(getSplitIndex(m_result->source, s_yandexTranslateLimit));
     buildNetworkRequestState(detectState, &QOnlineTranslator::requestYandexTranslate, &QOnlineTranslator::parseYandexTranslate, text);
 }
 
@@ -1887,11 +2156,13 @@ void QOnlineTranslator::buildBingStateMachine()
         credentialsState->setInitialState(new QFinalState(credentialsState));
 
     // Setup translation state
-    buildSplitNetworkRequest(translationState, &QOnlineTranslator::requestBingTranslate, &QOnlineTranslator::parseBingTranslate, m_source, s_bingTranslateLimit);
+    buildSplitNetworkRequest(translationState, &QOnlineTranslator::requestBingTranslate, &QOnlineTranslator::parseBingTranslate, m_result->source, s_bingTranslateLimit);
 
-    // Setup dictionary state
-    if (m_translationOptionsEnabled && !isContainsSpace(m_source))
-        buildNetworkRequestState(dictionaryState, &QOnlineTranslator::requestBingDictionary, &QOnlineTranslator::parseBingDictionary, m_source);
+    // Setup dictionary state (requested later by fetchDictionary() in lazy mode)
+    const bool isDictionaryNeeded = m_translationOptionsEnabled && !isContainsSpace(m_result->source);
+    m_dictionaryPending = isDictionaryNeeded && m_lazyDictionaryEnabled && !m_streaming && !m_incremental;
+    if (isDictionaryNeeded && !m_dictionaryPending)
+        buildNetworkRequestState(dictionaryState, &QOnlineTranslator::requestBingDictionary, &QOnlineTranslator::parseBingDictionary, m_result->source);
     else
         dictionaryState->setInitialState(new QFinalState(dictionaryState));
 }
@@ -1906,27 +2177,30 @@ void QOnlineTranslator::buildBingDetectStateMachine()
     detectState->addTransition(detectState, &QState::finished, finalState);
 
     // Setup translation state
-    const QString text = m_source.left(getSplitIndex(m_source, s_bingTranslateLimit));
+    const QString text = m_result->source.left(getSplitIndex(m_result->source, s_bingTranslateLimit));
     buildNetworkRequestState(detectState, &QOnlineTranslator::requestBingTranslate, &QOnlineTranslator::parseBingTranslate, text);
 }
 
 void QOnlineTranslator::buildLibreStateMachine()
 {
     // States
-    auto *languageDetectionState = new QState(m_stateMachine);
     auto *translationState = new QState(m_stateMachine);
     auto *finalState = new QFinalState(m_stateMachine);
-    m_stateMachine->setInitialState(languageDetectionState);
+    m_stateMachine->setInitialState(translationState);
 
     // Transitions
-    languageDetectionState->addTransition(languageDetectionState, &QState::finished, translationState);
     translationState->addTransition(translationState, &QState::finished, finalState);
 
-    // Setup LibreTranslate lang code detection
-    buildNetworkRequestState(languageDetectionState, &QOnlineTranslator::requestLibreLangDetection, &QOnlineTranslator::parseLibreLangDetection, m_source);
+    // Setup LibreTranslate lang code detection, it's not needed if the source language is already known
+    if (m_result->sourceLang == Auto) {
+        auto *languageDetectionState = new QState(m_stateMachine);
+        m_stateMachine->setInitialState(languageDetectionState);
+        languageDetectionState->addTransition(languageDetectionState, &QState::finished, translationState);
+        buildNetworkRequestState(languageDetectionState, &QOnlineTranslator::requestLibreLangDetection, &QOnlineTranslator::parseLibreLangDetection, m_result->source);
+    }
 
     // Setup translation state
-    buildSplitNetworkRequest(translationState, &QOnlineTranslator::requestLibreTranslate, &QOnlineTranslator::parseLibreTranslate, m_source, s_libreTranslateLimit);
+    buildSplitNetworkRequest(translationState, &QOnlineTranslator::requestLibreTranslate, &QOnlineTranslator::parseLibreTranslate, m_result->source, s_libreTranslateLimit);
 }
 
 void QOnlineTranslator::buildLibreDetectStateMachine()
@@ -1939,7 +2213,7 @@ void QOnlineTranslator::buildLibreDetectStateMachine()
     detectState->addTransition(detectState, &QState::finished, finalState);
 
     // Setup lang detection state
-    const QString text = m_source.left(getSplitIndex(m_source, s_libreTranslateLimit));
+    const QString text = m_result->source.left(getSplitIndex(m_result->source, s_libreTranslateLimit));
     buildNetworkRequestState(detectState, &QOnlineTranslator::requestLibreLangDetection, &QOnlineTranslator::parseLibreLangDetection, text);
 }
 
@@ -1954,7 +2228,7 @@ void QOnlineTranslator::buildLingvaStateMachine()
     translationState->addTransition(translationState, &QState::finished, finalState);
 
     // Setup translation state
-    buildSplitNetworkRequest(translationState, &QOnlineTranslator::requestLingvaTranslate, &QOnlineTranslator::parseLingvaTranslate, m_source, s_googleTranslateLimit);
+    buildSplitNetworkRequest(translationState, &QOnlineTranslator::requestLingvaTranslate, &QOnlineTranslator::parseLingvaTranslate, m_result->source, s_googleTranslateLimit, s_lingvaUrlLimit);
 }
 
 void QOnlineTranslator::buildLingvaDetectStateMachine()
@@ -1967,13 +2241,36 @@ void QOnlineTranslator::buildLingvaDetectStateMachine()
     detectState->addTransition(detectState, &QState::finished, finalState);
 
     // Setup lang detection state
-    const QString text = m_source.left(getSplitIndex(m_source, s_googleTranslateLimit));
+    const QString text = m_result->source.left(getSplitIndex(m_result->source, getEncodedLimit(m_result->source, s_googleTranslateLimit, s_lingvaUrlLimit)));
     buildNetworkRequestState(detectState, &QOnlineTranslator::requestLingvaTranslate, &QOnlineTranslator::parseLingvaTranslate, text);
 }
 
-void QOnlineTranslator::buildSplitNetworkRequest(QState *parent, void (QOnlineTranslator::*requestMethod)(), void (QOnlineTranslator::*parseMethod)(), const QString &text, int textLimit)
+void QOnlineTranslator::buildDictionaryStateMachine()
+{
+    // States
+    auto *dictionaryState = new QState(m_stateMachine);
+    auto *finalState = new QFinalState(m_stateMachine);
+    m_stateMachine->setInitialState(dictionaryState);
+
+    // Transitions
+    dictionaryState->addTransition(dictionaryState, &QState::finished, finalState);
+
+    // Setup dictionary state
+    if (m_result->engine == Yandex)
+        buildNetworkRequestState(dictionaryState, &QOnlineTranslator::requestYandexDictionary, &QOnlineTranslator::parseYandexDictionary, m_result->source);
+    else
+        buildNetworkRequestState(dictionaryState, &QOnlineTranslator::requestBingDictionary, &QOnlineTranslator::parseBingDictionary, m_result->source);
+}
+
+void QOnlineTranslator::buildSplitNetworkRequest(QState *parent, void (QOnlineTranslator::*requestMethod)(), void (QOnlineTranslator::*parseMethod)(), const QString &text, int textLimit, int encodedTextLimit)
 {
     QString unsendedText = text;
+    const bool isTranslation = requestStage(requestMethod) == QTranslationTimings::Translation;
+    int chunkIndex = 0;
+
+    // Smaller parts allow to retranslate only the changed sentences next time
+    if (m_incremental && isTranslation)
+        textLimit = qMin(textLimit, s_incrementalSegmentLimit);
     auto *nextTranslationState = new QState(parent);
     parent->setInitialState(nextTranslationState);
 
@@ -1981,28 +2278,46 @@ void QOnlineTranslator::buildSplitNetworkRequest(QState *parent, void (QOnlineTr
         auto *currentTranslationState = nextTranslationState;
         nextTranslationState = new QState(parent);
 
-        // Do not translate the part if it looks like garbage
-        const int splitIndex = getSplitIndex(unsendedText, textLimit);
-        if (splitIndex == -1) {
-            currentTranslationState->setProperty(s_textProperty, unsendedText.left(textLimit));
+        // Engines that pass the text in the URL are also limited by the length of the encoded text
+        const int limit = encodedTextLimit == 0 ? textLimit : getEncodedLimit(unsendedText, textLimit, encodedTextLimit);
+
+        // Do not translate the part if it contains only whitespaces, engines localize numbers and punctuation, so they are sent.
+        // The language is detected by the first part, so it's always sent when the source language is unknown.
+        const int splitIndex = getSplitIndex(unsendedText, limit);
+        const bool isGarbage = isTranslation && (chunkIndex != 0 || m_result->sourceLang != Auto)
+            && unsendedText.leftRef(splitIndex).trimmed().isEmpty();
+        if (isGarbage) {
+            const QString garbage = unsendedText.left(splitIndex);
+            currentTranslationState->setProperty(s_textProperty, garbage);
             currentTranslationState->addTransition(nextTranslationState);
             connect(currentTranslationState, &QState::entered, this, &QOnlineTranslator::skipGarbageText);
+            if (m_incremental)
+                m_changedSegments.append({garbage, {}});
+            connect(currentTranslationState, &QState::entered, this, [this, chunkIndex, translation = garbage.trimmed()] {
+                emit chunkTranslated(chunkIndex, translation);
+                emit progress(chunkIndex + 1, m_translationChunksCount);
+            });
 
             // Remove the parsed part from the next parsing
-            unsendedText = unsendedText.mid(textLimit);
+            unsendedText = unsendedText.mid(splitIndex);
         } else {
-            buildNetworkRequestState(currentTranslationState, requestMethod, parseMethod, unsendedText.left(splitIndex));
+            if (m_incremental && isTranslation)
+                m_changedSegments.append({unsendedText.left(splitIndex), {}});
+            buildNetworkRequestState(currentTranslationState, requestMethod, parseMethod, unsendedText.left(splitIndex), chunkIndex);
             currentTranslationState->addTransition(currentTranslationState, &QState::finished, nextTranslationState);
 
             // Remove the parsed part from the next parsing
             unsendedText = unsendedText.mid(splitIndex);
         }
+        ++chunkIndex;
     }
 
     nextTranslationState->addTransition(new QFinalState(parent));
+    if (isTranslation)
+        m_translationChunksCount = chunkIndex;
 }
 
-void QOnlineTranslator::buildNetworkRequestState(QState *parent, void (QOnlineTranslator::*requestMethod)(), void (QOnlineTranslator::*parseMethod)(), const QString &text)
+void QOnlineTranslator::buildNetworkRequestState(QState *parent, void (QOnlineTranslator::*requestMethod)(), void (QOnlineTranslator::*parseMethod)(), const QString &text, int chunkIndex)
 {
     // Network substates
     auto *requestingState = new QState(parent);
@@ -2011,34 +2326,113 @@ void QOnlineTranslator::buildNetworkRequestState(QState *parent, void (QOnlineTr
     parent->setInitialState(requestingState);
 
     // Substates transitions
-    requestingState->addTransition(m_networkManager, &QNetworkAccessManager::finished, parsingState);
+    auto *replyTransition = new ReplyFinishedTransition(m_networkManager, m_currentReply);
+    replyTransition->setTargetState(parsingState);
+    requestingState->addTransition(replyTransition);
     parsingState->addTransition(new QFinalState(parent));
 
     // Setup requesting state
     requestingState->setProperty(s_textProperty, text);
+    const QTranslationTimings::Stage stage = requestStage(requestMethod);
+    connect(requestingState, &QState::entered, this, &QOnlineTranslator::startRequestMeasurement);
     connect(requestingState, &QState::entered, this, requestMethod);
+    connect(requestingState, &QState::entered, this, [this, stage, chunkIndex] {
+        measureReply(stage, chunkIndex);
+    });
 
     // Setup parsing state
+    connect(parsingState, &QState::entered, this, [this, stage] {
+        startParseMeasurement(stage);
+        m_translationChunkStart = m_result->translation.size();
+    });
     connect(parsingState, &QState::entered, this, parseMethod);
+    connect(parsingState, &QState::entered, this, [this, stage] {
+        finishParseMeasurement(stage);
+    });
+
+    // Report parts of the split translation
+    if (stage == QTranslationTimings::Translation && chunkIndex != -1) {
+        connect(parsingState, &QState::entered, this, [this, chunkIndex] {
+            if (m_result->error != NoError)
+                return;
+
+            emit chunkTranslated(chunkIndex, m_result->translation.mid(m_translationChunkStart));
+            emit progress(chunkIndex + 1, m_translationChunksCount);
+        });
+    }
+}
+
+void QOnlineTranslator::buildTranslitState(QState *parent, QString QTranslationResultData::*text, Language QTranslationResultData::*language, QString QTranslationResultData::*translit)
+{
+    auto *transliterationState = new QState(parent);
+    parent->setInitialState(transliterationState);
+    transliterationState->addTransition(new QFinalState(parent));
+
+    // Fields are read on entering since the translation is not available yet
+    connect(transliterationState, &QState::entered, this, [this, text, language, translit] {
+        QTranslationResultData &result = *m_result;
+        result.*translit = QTransliterator::transliterate(result.*text, result.*language);
+    });
+}
+
+bool QOnlineTranslator::applyCachedDictionary()
+{
+    if (m_dictionaryCache == nullptr)
+        return false;
+
+    const std::optional<QDictionaryCache::Entry> entry = m_dictionaryCache->find(m_result->engine, m_result->sourceLang, m_result->translationLang, m_uiLang, m_result->source);
+    if (!entry) {
+        QTranslationMetrics::instance().recordCacheMiss(m_result->engine);
+        return false;
+    }
+
+    QTranslationMetrics::instance().recordCacheHit(m_result->engine);
+    applyDictionary(entry->translationOptions, entry->examples, entry->transcription);
+    return true;
 }
 
-void QOnlineTranslator::requestYandexTranslit(Language language)
+void QOnlineTranslator::applyDictionary(const QMap<QString, QVector<QOption>> &translationOptions, const QMap<QString, QVector<QExample>> &examples, const QString &transcription)
 {
+    m_result->translationOptions = translationOptions;
+    if (m_examplesEnabled)
+        m_result->examples = examples;
+    if (m_sourceTranscriptionEnabled && !transcription.isEmpty())
+        m_result->sourceTranscription = transcription;
+}
+
+void QOnlineTranslator::setDictionaryError(const QString &errorString)
+{
+    if (!m_fetchingDictionary) {
+        resetData(NetworkError, errorString);
+        return;
+    }
+
+    // Dictionary fetched on demand keeps the received translation
+    m_result->error = NetworkError;
+    m_result->errorString = errorString;
+}
+
+void QOnlineTranslator::requestYandexTranslit(Language language, QString &translit)
+{
+    const QString text = sender()->property(s_textProperty).toString();
+
     // Check if language is supported (need to check here because language may be autodetected)
-    if (!isSupportTranslit(Yandex, language)) {
+    const bool isLocal = QTransliterator::isSupported(language);
+    if (isLocal || !s_translitLanguages[Yandex].contains(language)) {
+        if (isLocal)
+            translit += QTransliterator::transliterate(text, language);
+
         auto *state = qobject_cast<QState *>(sender());
         state->addTransition(new QFinalState(state->parentState()));
         return;
     }
 
-    const QString text = sender()->property(s_textProperty).toString();
-
     // Generate API url
-    QUrl url(QStringLiteral("https://translate.yandex.net/translit/translit"));
-    url.setQuery("text=" + QUrl::toPercentEncoding(text)
-                 + "&lang=" + languageApiCode(Yandex, language));
+    QByteArray url = m_yandexUrl.toUtf8() + "/translit/translit?text=";
+    QPercentEncoder::append(url, text);
+    url += "&lang=" + languageApiCode(Yandex, language).toUtf8();
 
-    m_currentReply = m_networkManager->get(QNetworkRequest(url));
+    m_currentReply = m_networkManager->get(QNetworkRequest(QUrl::fromEncoded(url)));
 }
 
 void QOnlineTranslator::parseYandexTranslit(QString &text)
@@ -2060,17 +2454,202 @@ void QOnlineTranslator::parseYandexTranslit(QString &text)
 #endif
 }
 
+void QOnlineTranslator::startTranslation(const QString &text, Engine engine, Language translationLang, Language sourceLang, Language uiLang)
+{
+    resetData();
+
+    m_onlyDetectLanguage = false;
+    m_result->engine = engine;
+    startMeasurement();
+    m_result->source = text;
+    m_result->sourceLang = sourceLang;
+    m_result->translationLang = translationLang == Auto ? language(QLocale()) : translationLang;
+    m_uiLang = uiLang == Auto ? language(QLocale()) : uiLang;
+
+    if (m_result->sourceLang == Auto && m_offlineLanguageDetectionEnabled) {
+        const QLanguageDetector::Result detection = QLanguageDetector::detect(text);
+        if (detection.confidence >= s_offlineDetectionConfidence && isSupportTranslation(engine, detection.language))
+            m_result->sourceLang = detection.language;
+    }
+
+    // Check if the selected languages are supported by the engine
+    if (!isSupportTranslation(engine, m_result->sourceLang)) {
+        resetData(ParametersError, tr("Selected source language %1 is not supported for %2").arg(languageName(m_result->sourceLang), QMetaEnum::fromType<Engine>().valueToKey(engine)));
+        emit finished();
+        return;
+    }
+    if (!isSupportTranslation(engine, m_result->translationLang)) {
+        resetData(ParametersError, tr("Selected translation language %1 is not supported for %2").arg(languageName(m_result->translationLang), QMetaEnum::fromType<Engine>().valueToKey(engine)));
+        emit finished();
+        return;
+    }
+    if (!isSupportTranslation(engine, m_uiLang)) {
+        resetData(ParametersError, tr("Selected ui language %1 is not supported for %2").arg(languageName(m_uiLang), QMetaEnum::fromType<Engine>().valueToKey(engine)));
+        emit finished();
+        return;
+    }
+    if ((engine == LibreTranslate && m_libreUrl.isEmpty()) || (engine == Lingva && m_lingvaUrl.isEmpty())) {
+        resetData(ParametersError, tr("%1 URL can't be empty.").arg(QMetaEnum::fromType<Engine>().valueToKey(engine)));
+        emit finished();
+        return;
+    }
+
+    // Check devices for streaming translation
+    if (m_streaming) {
+        if (m_streamInput == nullptr || !m_streamInput->isReadable()) {
+            m_streaming = false;
+            resetData(ParametersError, tr("Input device is not opened for reading"));
+            emit finished();
+            return;
+        }
+        if (m_streamOutput == nullptr || !m_streamOutput->isWritable()) {
+            m_streaming = false;
+            resetData(ParametersError, tr("Output device is not opened for writing"));
+            emit finished();
+            return;
+        }
+    }
+
+    buildTranslationStateMachine();
+    m_stateMachine->start();
+}
+
+void QOnlineTranslator::onStateMachineFinished()
+{
+    if (m_fetchingDictionary) {
+        // Translation measurement is already reported, so the fetch is reported separately
+        finishMeasurement();
+        m_fetchingDictionary = false;
+        m_dictionaryRequested = false;
+        emit dictionaryFetched();
+        return;
+    }
+
+    if (m_incremental && m_result->error == NoError)
+        finishIncrementalTranslation();
+
+    if (!m_streaming) {
+        emit finished();
+
+        // Dictionary was requested before the translation was finished
+        if (m_dictionaryRequested) {
+            m_dictionaryRequested = false;
+            fetchDictionary();
+        }
+        return;
+    }
+
+    // Separate segments the same way as parts of the split translation
+    QByteArray translation;
+    if (m_streamSpaceNeeded && !m_result->translation.isEmpty() && !m_result->translation.at(0).isSpace())
+        translation += ' ';
+    translation += m_result->translation.toUtf8();
+    if (!m_result->translation.isEmpty())
+        m_streamSpaceNeeded = !m_result->translation.at(m_result->translation.size() - 1).isSpace();
+
+    if (m_streamOutput == nullptr || m_streamOutput->write(translation) == -1) {
+        m_streaming = false;
+        resetData(ParametersError, tr("Unable to write the translation: %1").arg(m_streamOutput == nullptr ? tr("Output device was destroyed") : m_streamOutput->errorString()));
+        emit finished();
+        return;
+    }
+
+    const QString segment = readStreamSegment();
+    if (segment.isEmpty()) {
+        m_streaming = false;
+        emit finished();
+        return;
+    }
+
+    // Measurements continue for the whole stream
+    resetData();
+    m_result->source = segment;
+    buildTranslationStateMachine();
+    m_stateMachine->start();
+}
+
+// Splice translated segments with the unchanged ones
+void QOnlineTranslator::finishIncrementalTranslation()
+{
+    QVector<Segment> segments;
+    segments.reserve(m_unchangedPrefixSize + m_changedSegments.size() + m_unchangedSuffixSize);
+    segments += m_segments.mid(0, m_unchangedPrefixSize);
+    segments += m_changedSegments;
+    segments += m_segments.mid(m_segments.size() - m_unchangedSuffixSize);
+    m_segments = qMove(segments);
+    m_changedSegments.clear();
+    m_segmentsSourceLang = m_result->sourceLang; // Detected language for Auto
+
+    m_result->source = m_incrementalSource;
+    m_result->translation.clear();
+    for (const Segment &segment : qAsConst(m_segments)) {
+        // Translations of the first parts do not contain separators
+        if (!m_result->translation.isEmpty() && !segment.translation.isEmpty() && !m_result->translation.at(m_result->translation.size() - 1).isSpace() && !segment.translation.at(0).isSpace())
+            m_result->translation += ' ';
+        m_result->translation += segment.translation;
+    }
+}
+
+// Read the next part of the input that fits into a single segment
+QString QOnlineTranslator::readStreamSegment()
+{
+    if (m_streamInput != nullptr && m_streamInput->isReadable()) {
+        while (m_streamBuffer.size() < s_streamSegmentLimit && !m_streamInput->atEnd()) {
+            // Each character takes at least one byte, so the segment is never exceeded
+            const QByteArray data = m_streamInput->read(s_streamSegmentLimit - m_streamBuffer.size());
+            if (data.isEmpty())
+                break;
+
+            // Multibyte character can be split between reads
+            m_streamIncompleteBytes += data;
+            int completeSize = m_streamIncompleteBytes.size();
+            for (int i = completeSize - 1; i >= 0 && i >= completeSize - 4; --i) {
+                const auto byte = static_cast<uchar>(m_streamIncompleteBytes.at(i));
+                if ((byte & 0xC0) == 0x80)
+                    continue;
+
+                const int length = byte >= 0xF0 ? 4 : byte >= 0xE0 ? 3 : byte >= 0xC0 ? 2 : 1;
+                if (i + length > completeSize)
+                    completeSize = i;
+                break;
+            }
+
+            m_streamBuffer += QString::fromUtf8(m_streamIncompleteBytes.constData(), completeSize);
+            m_streamIncompleteBytes.remove(0, completeSize);
+        }
+    }
+
+    if (m_streamBuffer.size() < s_streamSegmentLimit && !m_streamIncompleteBytes.isEmpty()) {
+        // The input ended with an invalid sequence
+        m_streamBuffer += QString::fromUtf8(m_streamIncompleteBytes);
+        m_streamIncompleteBytes.clear();
+    }
+
+    const int splitIndex = getSplitIndex(m_streamBuffer, s_streamSegmentLimit);
+    const QString segment = m_streamBuffer.left(splitIndex);
+    m_streamBuffer.remove(0, splitIndex);
+    return segment;
+}
+
 void QOnlineTranslator::resetData(TranslationError error, const QString &errorString)
 {
-    m_error = error;
-    m_errorString = errorString;
-    m_translation.clear();
-    m_translationTranslit.clear();
-    m_sourceTranslit.clear();
-    m_sourceTranscription.clear();
-    m_translationOptions.clear();
-    m_examples.clear();
+    m_result->error = error;
+    m_result->errorString = errorString;
+    m_result->translation.clear();
+    m_result->translationTranslit.clear();
+    m_result->sourceTranslit.clear();
+    m_result->sourceTranscription.clear();
+    m_result->translationOptions.clear();
+    m_result->examples.clear();
+    m_dictionaryPending = false;
+    m_dictionaryRequested = false;
+    m_fetchingDictionary = false;
 
+    resetStateMachine();
+}
+
+void QOnlineTranslator::resetStateMachine()
+{
     m_stateMachine->stop();
     for (QAbstractState *state : m_stateMachine->findChildren<QAbstractState *>()) {
         if (!m_stateMachine->configuration().contains(state))
@@ -2078,69 +2657,207 @@ void QOnlineTranslator::resetData(TranslationError error, const QString &errorSt
     }
 }
 
-bool QOnlineTranslator::isSupportTranslit(Engine engine, Language lang)
+QString QOnlineTranslator::engineUrl(Engine engine) const
 {
     switch (engine) {
     case Google:
-    case Lingva:
-        isSupportTranslation(Google, lang); // Google supports transliteration for all supported languages
-        break;
+        return m_googleUrl;
     case Yandex:
-        switch (lang) {
-        case Amharic:
-        case Armenian:
-        case Bengali:
-        case SimplifiedChinese:
-        case Georgian:
-        case Greek:
-        case Gujarati:
-        case Hebrew:
-        case Hindi:
-        case Japanese:
-        case Kannada:
-        case Korean:
-        case Malayalam:
-        case Marathi:
-        case Nepali:
-        case Punjabi:
-        case Russian:
-        case Sinhala:
-        case Tamil:
-        case Telugu:
-        case Thai:
-        case Yiddish:
-            return true;
-        default:
-            return false;
-        }
+        return m_yandexUrl;
     case Bing:
-        switch (lang) {
-        case Arabic:
-        case Bengali:
-        case Gujarati:
-        case Hebrew:
-        case Hindi:
-        case Japanese:
-        case Kannada:
-        case Malayalam:
-        case Marathi:
-        case Punjabi:
-        case SerbianCyrillic:
-        case SerbianLatin:
-        case Tamil:
-        case Telugu:
-        case Thai:
-        case SimplifiedChinese:
-        case TraditionalChinese:
-            return true;
-        default:
-            return false;
-        }
-    case LibreTranslate: // LibreTranslate doesn't support translit
-        return false;
+        return m_bingUrl;
+    case LibreTranslate:
+        return m_libreUrl;
+    case Lingva:
+        return m_lingvaUrl;
     }
 
-    return false;
+    Q_UNREACHABLE();
+}
+
+void QOnlineTranslator::startMeasurement()
+{
+    m_timings = {};
+    m_timer.start();
+
+    // Self-hosted engines may have no URL set, the translation will fail without requests
+    const QString url = engineUrl(m_result->engine);
+    m_latencyHistogram.reset();
+    if (!url.isEmpty())
+        m_latencyHistogram = QLatencyHistogram::instance(m_result->engine, url);
+
+    m_lastSpanId = 0;
+    if (m_tracer != nullptr) {
+        QTranslationSpan translationSpan = createSpan(++m_lastSpanId, rootStage());
+        translationSpan.type = QTranslationSpan::Translation;
+        m_tracer->spanStarted(translationSpan);
+    }
+}
+
+QTranslationTimings::Stage QOnlineTranslator::requestStage(void (QOnlineTranslator::*requestMethod)()) const
+{
+    if (requestMethod == &QOnlineTranslator::requestBingCredentials)
+        return QTranslationTimings::Credentials;
+
+    if (m_onlyDetectLanguage || requestMethod == &QOnlineTranslator::requestLibreLangDetection)
+        return QTranslationTimings::LanguageDetection;
+
+    if (requestMethod == &QOnlineTranslator::requestYandexSourceTranslit || requestMethod == &QOnlineTranslator::requestYandexTranslationTranslit)
+        return QTranslationTimings::Transliteration;
+
+    if (requestMethod == &QOnlineTranslator::requestYandexDictionary || requestMethod == &QOnlineTranslator::requestBingDictionary)
+        return QTranslationTimings::Dictionary;
+
+    return QTranslationTimings::Translation;
+}
+
+void QOnlineTranslator::finishMeasurement()
+{
+    m_timings.total = m_timer.nsecsElapsed() / 1000;
+    QTranslationMetrics::instance().recordTranslation(m_result->engine, m_result->error, m_timings);
+
+    if (m_tracer != nullptr && m_lastSpanId != 0) {
+        QTranslationSpan translationSpan = createSpan(1, rootStage());
+        translationSpan.type = QTranslationSpan::Translation;
+        translationSpan.bytesSent = m_timings.bytesSent();
+        translationSpan.bytesReceived = m_timings.bytesReceived();
+        translationSpan.error = m_result->error;
+        m_tracer->spanFinished(translationSpan);
+    }
+}
+
+void QOnlineTranslator::startRequestMeasurement()
+{
+    // Request methods can skip the state without sending a request, reset the reply to detect it
+    m_currentReply = nullptr;
+    m_requestStart = m_timer.nsecsElapsed();
+    m_responseStart = -1;
+    m_requestBytesSent = 0;
+}
+
+void QOnlineTranslator::measureReply(QTranslationTimings::Stage stage, int chunkIndex)
+{
+    if (m_currentReply == nullptr)
+        return;
+
+    if (m_timings.requests() == 0)
+        m_timings.queueWait = m_requestStart / 1000;
+    ++m_timings.stages[stage].requests;
+
+    if (m_tracer != nullptr) {
+        m_requestSpanId = ++m_lastSpanId;
+        m_requestChunkIndex = chunkIndex;
+
+        QTranslationSpan requestSpan = createSpan(m_requestSpanId, stage, chunkIndex);
+        requestSpan.type = QTranslationSpan::Request;
+        m_tracer->spanStarted(requestSpan);
+    }
+
+#ifndef QT_NO_SSL
+    connect(m_currentReply, &QNetworkReply::encrypted, this, [this, stage] {
+        m_timings.stages[stage].connectTime += (m_timer.nsecsElapsed() - m_requestStart) / 1000;
+    });
+#endif
+    connect(m_currentReply, &QNetworkReply::metaDataChanged, this, [this, stage] {
+        if (m_responseStart != -1)
+            return;
+
+        m_responseStart = m_timer.nsecsElapsed();
+        m_timings.stages[stage].firstByteTime += (m_responseStart - m_requestStart) / 1000;
+    });
+    connect(m_currentReply, &QNetworkReply::uploadProgress, this, [this](qint64 bytesSent) {
+        m_requestBytesSent = bytesSent;
+    });
+}
+
+void QOnlineTranslator::startParseMeasurement(QTranslationTimings::Stage stage)
+{
+    m_parseStart = m_timer.nsecsElapsed();
+
+    QTranslationTimings::StageTimings &timings = m_timings.stages[stage];
+    if (m_responseStart == -1) {
+        // Failed requests may finish without headers
+        timings.firstByteTime += (m_parseStart - m_requestStart) / 1000;
+    } else {
+        timings.downloadTime += (m_parseStart - m_responseStart) / 1000;
+    }
+
+    if (m_currentReply != nullptr && m_latencyHistogram != nullptr)
+        m_latencyHistogram->record((m_parseStart - m_requestStart) / 1000);
+
+    // Should be read before parsing, because parsing reads the whole reply
+    const qint64 bytesReceived = m_currentReply != nullptr ? m_currentReply->bytesAvailable() : 0;
+    timings.bytesSent += m_requestBytesSent;
+    timings.bytesReceived += bytesReceived;
+
+    if (m_tracer != nullptr) {
+        QTranslationSpan requestSpan = createSpan(m_requestSpanId, stage, m_requestChunkIndex);
+        requestSpan.type = QTranslationSpan::Request;
+        requestSpan.bytesSent = m_requestBytesSent;
+        requestSpan.bytesReceived = bytesReceived;
+        if (m_currentReply == nullptr || m_currentReply->error() != QNetworkReply::NoError)
+            requestSpan.error = NetworkError;
+        m_tracer->spanFinished(requestSpan);
+
+        m_parseSpanId = ++m_lastSpanId;
+        QTranslationSpan parseSpan = createSpan(m_parseSpanId, stage, m_requestChunkIndex);
+        parseSpan.type = QTranslationSpan::Parsing;
+        m_tracer->spanStarted(parseSpan);
+    }
+}
+
+void QOnlineTranslator::finishParseMeasurement(QTranslationTimings::Stage stage)
+{
+    m_timings.stages[stage].parseTime += (m_timer.nsecsElapsed() - m_parseStart) / 1000;
+
+    if (m_tracer != nullptr) {
+        QTranslationSpan parseSpan = createSpan(m_parseSpanId, stage, m_requestChunkIndex);
+        parseSpan.type = QTranslationSpan::Parsing;
+        parseSpan.error = m_result->error;
+        m_tracer->spanFinished(parseSpan);
+    }
+}
+
+// Dictionary fetched on demand is measured separately from the translation
+QTranslationTimings::Stage QOnlineTranslator::rootStage() const
+{
+    return m_fetchingDictionary ? QTranslationTimings::Dictionary : QTranslationTimings::Translation;
+}
+
+QTranslationSpan QOnlineTranslator::createSpan(int id, QTranslationTimings::Stage stage, int chunkIndex) const
+{
+    QTranslationSpan span;
+    span.id = id;
+    span.parentId = id == 1 ? 0 : 1;
+    span.translator = this;
+    span.engine = m_result->engine;
+    span.stage = stage;
+    span.chunkIndex = chunkIndex;
+    return span;
+}
+
+void QOnlineTranslator::preconnectToHost(const QUrl &url)
+{
+    // Self-hosted engines may have no URL set yet
+    if (url.host().isEmpty())
+        return;
+
+#ifndef QT_NO_SSL
+    if (url.scheme() == QLatin1String("https")) {
+        m_networkManager->connectToHostEncrypted(url.host(), static_cast<quint16>(url.port(443)));
+        return;
+    }
+#endif
+    m_networkManager->connectToHost(url.host(), static_cast<quint16>(url.port(80)));
+}
+
+bool QOnlineTranslator::isSupportTranslit(Engine engine, Language lang)
+{
+    // Yandex transliteration is performed locally for the common scripts
+    if (engine == Yandex && QTransliterator::isSupported(lang))
+        return true;
+
+    return s_translitLanguages[engine].contains(lang);
 }
 
 bool QOnlineTranslator::isSupportDictionary(Engine engine, Language sourceLang, Language translationLang)
@@ -2406,6 +3123,14 @@ bool QOnlineTranslator::isSupportDictionary(Engine engine, Language sourceLang,
     return false;
 }
 
+const QByteArray &QOnlineTranslator::yandexUcid()
+{
+    // Generated lazily to not call the random generator during static initialization
+    if (s_yandexUcid.isEmpty())
+        s_yandexUcid = QUuid::createUuid().toByteArray(QUuid::Id128);
+    return s_yandexUcid;
+}
+
 // Returns engine-specific language code for translation
 QString QOnlineTranslator::languageApiCode(Engine engine, Language lang)
 {
@@ -2414,15 +3139,15 @@ QString QOnlineTranslator::languageApiCode(Engine engine, Language lang)
 
     switch (engine) {
     case Google:
-        return s_googleLanguageCodes.value(lang, s_genericLanguageCodes.value(lang));
+        return findLanguageCode(s_googleLanguageCodes, lang);
     case Yandex:
-        return s_yandexLanguageCodes.value(lang, s_genericLanguageCodes.value(lang));
+        return findLanguageCode(s_yandexLanguageCodes, lang);
     case Bing:
-        return s_bingLanguageCodes.value(lang, s_genericLanguageCodes.value(lang));
+        return findLanguageCode(s_bingLanguageCodes, lang);
     case LibreTranslate:
-        return s_genericLanguageCodes.value(lang);
+        return findLanguageCode(s_genericLanguageCodesTable, lang);
     case Lingva:
-        return s_lingvaLanguageCodes.value(lang, s_genericLanguageCodes.value(lang));
+        return findLanguageCode(s_lingvaLanguageCodes, lang);
     }
 
     Q_UNREACHABLE();
@@ -2431,23 +3156,46 @@ QString QOnlineTranslator::languageApiCode(Engine engine, Language lang)
 // Parse language from response language code
 QOnlineTranslator::Language QOnlineTranslator::language(Engine engine, const QString &langCode)
 {
-    // Engine exceptions
     switch (engine) {
     case Google:
-        return s_googleLanguageCodes.key(langCode, s_genericLanguageCodes.key(langCode, NoLanguage));
+        return findLanguage(s_googleLanguageCodes, langCode);
     case Yandex:
-        return s_yandexLanguageCodes.key(langCode, s_genericLanguageCodes.key(langCode, NoLanguage));
+        return findLanguage(s_yandexLanguageCodes, langCode);
     case Bing:
-        return s_bingLanguageCodes.key(langCode, s_genericLanguageCodes.key(langCode, NoLanguage));
+        return findLanguage(s_bingLanguageCodes, langCode);
     case LibreTranslate:
-        return s_genericLanguageCodes.key(langCode, NoLanguage);
+        return findLanguage(s_genericLanguageCodesTable, langCode);
     case Lingva:
-        return s_lingvaLanguageCodes.key(langCode, s_genericLanguageCodes.key(langCode, NoLanguage));
+        return findLanguage(s_lingvaLanguageCodes, langCode);
     }
 
     Q_UNREACHABLE();
 }
 
+template<size_t N>
+QString QOnlineTranslator::findLanguageCode(const LanguageCodesTable<N> &table, Language lang)
+{
+    if (lang == NoLanguage)
+        return {};
+
+    // Codes are stored in static memory, no need to copy them
+    const std::u16string_view code = table.codes[lang];
+    return QString::fromRawData(reinterpret_cast<const QChar *>(code.data()), static_cast<int>(code.size()));
+}
+
+template<size_t N>
+QOnlineTranslator::Language QOnlineTranslator::findLanguage(const LanguageCodesTable<N> &table, const QString &langCode)
+{
+    const std::u16string_view code(reinterpret_cast<const char16_t *>(langCode.utf16()), static_cast<size_t>(langCode.size()));
+    const auto it = std::lower_bound(table.index.cbegin(), table.index.cend(), code, [](const LanguageCode &entry, std::u16string_view value) {
+        return entry.code < value;
+    });
+    if (it == table.index.cend() || it->code != code)
+        return NoLanguage;
+
+    return it->language;
+}
+
 // Get split index of the text according to the limit
 int QOnlineTranslator::getSplitIndex(const QString &untranslatedText, int limit)
 {
@@ -2475,11 +3223,43 @@ int QOnlineTranslator::getSplitIndex(const QString &untranslatedText, int limit)
     return limit;
 }
 
+// Get the number of characters (up to the limit) whose percent-encoded UTF-8 representation fits into the byte limit
+int QOnlineTranslator::getEncodedLimit(const QString &text, int limit, int encodedLimit)
+{
+    const int size = qMin(text.size(), limit);
+    int encodedSize = 0;
+    for (int i = 0; i < size; ++i) {
+        const ushort symbol = text.at(i).unicode();
+        int symbolSize;
+        if (symbol < 0x80) {
+            // Unreserved characters are not encoded by QPercentEncoder
+            const bool isUnreserved = (symbol >= 'a' && symbol <= 'z') || (symbol >= 'A' && symbol <= 'Z') || (symbol >= '0' && symbol <= '9')
+                || symbol == '-' || symbol == '.' || symbol == '_' || symbol == '~';
+            symbolSize = isUnreserved ? 1 : 3;
+        } else if (symbol < 0x800) {
+            symbolSize = 6;
+        } else if (QChar::isHighSurrogate(symbol) && i + 1 < size && text.at(i + 1).isLowSurrogate()) {
+            // Surrogate pair is encoded as 4 bytes and should not be splitted
+            if (encodedSize + 12 > encodedLimit)
+                return i;
+            encodedSize += 12;
+            ++i;
+            continue;
+        } else {
+            symbolSize = 9;
+        }
+
+        if (encodedSize + symbolSize > encodedLimit)
+            return i;
+        encodedSize += symbolSize;
+    }
+
+    return limit;
+}
+
 bool QOnlineTranslator::isContainsSpace(const QString &text)
 {
-    return std::any_of(text.cbegin(), text.cend(), [](QChar symbol) {
-        return symbol.isSpace();
-    });
+    return QScriptHistogram::indexOfWhitespace(text.constData(), text.size()) != -1;
 }
 
 void QOnlineTranslator::addSpaceBetweenParts(QString &text)
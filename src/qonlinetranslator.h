@@ -22,16 +22,31 @@
 
 #include "qexample.h"
 #include "qoption.h"
+#include "qtranslationtimings.h"
 
+#include <QElapsedTimer>
 #include <QMap>
 #include <QPointer>
-#include <QUuid>
+#include <QSharedDataPointer>
+#include <QSharedPointer>
 #include <QVector>
 
+#include <array>
+#include <initializer_list>
+#include <string_view>
+
 class QStateMachine;
 class QState;
 class QNetworkAccessManager;
 class QNetworkReply;
+class QUrl;
+class QIODevice;
+class QDictionaryCache;
+class QLatencyHistogram;
+class QTranslationResult;
+struct QTranslationResultData;
+class QTranslationTracer;
+struct QTranslationSpan;
 
 /**
  * @brief Provides translation data
@@ -42,6 +57,7 @@ class QOnlineTranslator : public QObject
     Q_DISABLE_COPY(QOnlineTranslator)
 
     friend class QOnlineTts;
+    friend class QOnlineTranslatorPrivateAccess;
 
 public:
     /**
@@ -205,6 +221,7 @@ public:
         /** The request could not be parsed (report a bug if you see this) */
         ParsingError
     };
+    Q_ENUM(TranslationError)
 
     /**
      * @brief Create object
@@ -215,6 +232,7 @@ public:
      * @param parent parent object
      */
     explicit QOnlineTranslator(QObject *parent = nullptr);
+    ~QOnlineTranslator() override;
 
     /**
      * @brief Translate text
@@ -227,6 +245,39 @@ public:
      */
     void translate(const QString &text, Engine engine = Google, Language translationLang = Auto, Language sourceLang = Auto, Language uiLang = Auto);
 
+    /**
+     * @brief Translate text from the device
+     *
+     * Reads the input by segments of a few thousand characters, translates them one by one
+     * and writes the translation of each segment to the output as UTF-8 before reading the next one,
+     * so only the current segment is kept in memory.
+     * The input should be UTF-8 and provide data without waiting, e.g. a file or a buffer.
+     * After finished() signal the object contains data only of the last segment.
+     *
+     * @param input device to read the text from
+     * @param output device to write the translation to
+     * @param engine online engine to use
+     * @param translationLang language to translation
+     * @param sourceLang language of the text
+     * @param uiLang ui language to use for display
+     */
+    void translate(QIODevice *input, QIODevice *output, Engine engine = Google, Language translationLang = Auto, Language sourceLang = Auto, Language uiLang = Auto);
+
+    /**
+     * @brief Translate edited text
+     *
+     * Translates text by parts of a few sentences and keeps them. The next call with the same languages and engine
+     * compares the text with the kept parts and sends only the changed ones, translation of the rest is reused.
+     * Only translation() and source() describe the whole text, other data is related to the changed part.
+     *
+     * @param text text to translate
+     * @param engine online engine to use
+     * @param translationLang language to translation
+     * @param sourceLang language of the passed text
+     * @param uiLang ui language to use for display
+     */
+    void translateIncremental(const QString &text, Engine engine = Google, Language translationLang = Auto, Language sourceLang = Auto, Language uiLang = Auto);
+
     /**
      * @brief Detect language
      *
@@ -235,6 +286,18 @@ public:
      */
     void detectLanguage(const QString &text, Engine engine = Google);
 
+    /**
+     * @brief Open connections to the engine hosts in advance
+     *
+     * Resolves the engine host and performs TCP and TLS handshakes without sending a request,
+     * so the first translate() call does not pay for them.
+     * Connections are kept by the network manager of this object, so call it on the instance that will perform the translation.
+     * The URL set by setEngineUrl() is used.
+     *
+     * @param engine engine to connect to
+     */
+    void preconnect(Engine engine);
+
     /**
      * @brief Cancel translation operation (if any).
      */
@@ -247,6 +310,16 @@ public:
      */
     bool isRunning() const;
 
+    /**
+     * @brief Fetch translation options and examples of the last translation
+     *
+     * Requests the dictionary that was skipped because of setLazyDictionaryEnabled() and emits dictionaryFetched() when
+     * translationOptions() and examples() are ready. If the translation is still running, the dictionary is fetched after it's finished.
+     * If there is nothing to fetch, the signal is emitted immediately.
+     * The fetch is measured as a separate operation: timings(), the metrics registry and the tracer report it on its own.
+     */
+    void fetchDictionary();
+
     /**
      * @brief Converts the object to JSON
      *
@@ -254,6 +327,27 @@ public:
      */
     QJsonDocument toJson() const;
 
+    /**
+     * @brief Result of the last translation
+     *
+     * The result shares the data with the translator, so the call does not copy the texts.
+     *
+     * @return immutable copy of the translation data
+     * @sa QTranslationResult
+     */
+    QTranslationResult result() const;
+
+    /**
+     * @brief Move the result of the last translation out of the object
+     *
+     * Leaves the translation data of the object empty, so the result is not shared with it.
+     * Should be called after finished() signal.
+     *
+     * @return translation data
+     * @sa QTranslationResult
+     */
+    QTranslationResult takeResult();
+
     /**
      * @brief Source text
      *
@@ -320,6 +414,8 @@ public:
     /**
      * @brief Translation options
      *
+     * With lazy dictionary enabled, options of Yandex and Bing are available only after fetchDictionary().
+     *
      * @return QMap whose key represents the type of speech, and the value is a QVector of translation options
      * @sa QOption
      */
@@ -328,11 +424,21 @@ public:
     /**
      * @brief Translation examples
      *
+     * With lazy dictionary enabled, examples of Yandex and Bing are available only after fetchDictionary().
+     *
      * @return QMap whose key represents the type of speech, and the value is a QVector of translation examples
      * @sa QExample
      */
     QMap<QString, QVector<QExample>> examples() const;
 
+    /**
+     * @brief Time measurements
+     *
+     * @return times and sizes of requests that were made during the last translation, language detection or fetchDictionary()
+     * @sa QTranslationTimings
+     */
+    QTranslationTimings timings() const;
+
     /**
      * @brief Last error
      *
@@ -427,17 +533,114 @@ public:
      */
     void setExamplesEnabled(bool enable);
 
+    /**
+     * @brief Check if offline language detection is enabled
+     *
+     * @return `true` if offline language detection is enabled
+     * @sa QLanguageDetector
+     */
+    bool isOfflineLanguageDetectionEnabled() const;
+
+    /**
+     * @brief Enable or disable offline language detection
+     *
+     * When enabled, the source language of translate() with `Auto` source language and the result of detectLanguage()
+     * are determined locally if the detection is confident enough and the language is supported by the engine,
+     * otherwise the engine is used.
+     * This saves a request for LibreTranslate, which detects language separately, and the whole request for detectLanguage().
+     * Disabled by default.
+     *
+     * @param enable whether to enable offline language detection
+     * @sa QLanguageDetector
+     */
+    void setOfflineLanguageDetectionEnabled(bool enable);
+
+    /**
+     * @brief Check if translation options and examples are fetched on demand
+     *
+     * @return `true` if lazy dictionary is enabled
+     */
+    bool isLazyDictionaryEnabled() const;
+
+    /**
+     * @brief Enable or disable fetching translation options and examples on demand
+     *
+     * Yandex and Bing need an additional request to get the dictionary of a single word.
+     * When enabled, finished() is emitted as soon as the translation is ready and the dictionary is requested only by fetchDictionary().
+     * Other engines return the dictionary with the translation, so they are not affected.
+     * Disabled by default.
+     *
+     * @param enable whether to enable lazy dictionary
+     */
+    void setLazyDictionaryEnabled(bool enable);
+
     /**
      * @brief Set the URL engine
      *
-     * Only affects LibreTranslate and Lingva because these engines have multiple instances.
-     * You need to call this function to specify the URL of an instance for them.
+     * LibreTranslate and Lingva have multiple instances, so you need to call this function to specify the URL of an instance for them.
+     * For other engines it overrides the default URL, e.g. to use a proxy or a local stand-in server.
+     * Pass an empty URL to restore the default one.
      *
      * @param engine engine
      * @param url engine url
      */
     void setEngineUrl(Engine engine, QString url);
 
+    /**
+     * @brief Network access manager
+     *
+     * @return network access manager that is used to send requests
+     */
+    QNetworkAccessManager *networkAccessManager() const;
+
+    /**
+     * @brief Set network access manager
+     *
+     * Allows to use a custom transport, e.g. a QNetworkAccessManager subclass that records or replays replies.
+     * The object does not take ownership of the passed manager. The manager can be shared between translators,
+     * each of them handles only its own replies.
+     * Should not be called while the translation is running.
+     *
+     * @param manager network access manager to send requests with, `nullptr` restores the default one
+     */
+    void setNetworkAccessManager(QNetworkAccessManager *manager);
+
+    /**
+     * @brief Tracer
+     *
+     * @return tracer that receives spans of translations or `nullptr` if not set
+     */
+    QTranslationTracer *tracer() const;
+
+    /**
+     * @brief Set tracer
+     *
+     * The object does not take ownership of the passed tracer.
+     * Should not be called while the translation is running.
+     *
+     * @param tracer tracer to receive spans of translations, `nullptr` to disable tracing
+     */
+    void setTracer(QTranslationTracer *tracer);
+
+    /**
+     * @brief Dictionary cache
+     *
+     * @return cache of translation options and examples or `nullptr` if not set
+     */
+    QDictionaryCache *dictionaryCache() const;
+
+    /**
+     * @brief Set dictionary cache
+     *
+     * Yandex and Bing request translation options and examples of a single word with an additional request,
+     * it's skipped if the dictionary of the word is found in the cache.
+     * The object does not take ownership of the passed cache, the same cache can be shared between several translators.
+     * Should not be called while the translation is running.
+     *
+     * @param cache cache to store dictionaries, `nullptr` to disable caching
+     */
+    void setDictionaryCache(QDictionaryCache *cache);
+
     /**
      * @brief Set api key for engine
      *
@@ -489,6 +692,14 @@ public:
      */
     static bool isSupportTranslation(Engine engine, Language lang);
 
+    /**
+     * @brief Languages supported for translation
+     *
+     * @param engine engine
+     * @return all languages that the specified engine supports for translation in the order of the enumeration
+     */
+    static QVector<Language> supportedLanguages(Engine engine);
+
 signals:
     /**
      * @brief Translation finished
@@ -497,6 +708,35 @@ signals:
      */
     void finished();
 
+    /**
+     * @brief Dictionary fetched
+     *
+     * This signal is called when fetchDictionary() is complete.
+     * On failure error() is set, but the translation is kept.
+     */
+    void dictionaryFetched();
+
+    /**
+     * @brief Part of the translation is ready
+     *
+     * Long text is translated by parts, this signal is emitted when the translation of each part is received.
+     * Concatenated texts of all parts are equal to translation().
+     *
+     * @param index index of the part starting from 0
+     * @param text translated text of the part, including the separator from the previous part
+     */
+    void chunkTranslated(int index, const QString &text);
+
+    /**
+     * @brief Translation progress
+     *
+     * Emitted after each chunkTranslated() signal.
+     *
+     * @param done number of translated parts
+     * @param total number of parts
+     */
+    void progress(int done, int total);
+
 private slots:
     void skipGarbageText();
 
@@ -543,6 +783,12 @@ private:
      * Also Yandex and Bing requires several requests to get dictionary, transliteration etc.
      * We use state machine to rely async computation with signals and slots.
      */
+    void startTranslation(const QString &text, Engine engine, Language translationLang, Language sourceLang, Language uiLang);
+    void onStateMachineFinished();
+    void finishIncrementalTranslation();
+    QString readStreamSegment();
+
+    void buildTranslationStateMachine();
     void buildGoogleStateMachine();
     void buildGoogleDetectStateMachine();
 
@@ -558,15 +804,40 @@ private:
     void buildLingvaStateMachine();
     void buildLingvaDetectStateMachine();
 
+    void buildDictionaryStateMachine();
+
     // Helper functions to build nested states
-    void buildSplitNetworkRequest(QState *parent, void (QOnlineTranslator::*requestMethod)(), void (QOnlineTranslator::*parseMethod)(), const QString &text, int textLimit);
-    void buildNetworkRequestState(QState *parent, void (QOnlineTranslator::*requestMethod)(), void (QOnlineTranslator::*parseMethod)(), const QString &text = {});
+    void buildSplitNetworkRequest(QState *parent, void (QOnlineTranslator::*requestMethod)(), void (QOnlineTranslator::*parseMethod)(), const QString &text, int textLimit, int encodedTextLimit = 0);
+    void buildNetworkRequestState(QState *parent, void (QOnlineTranslator::*requestMethod)(), void (QOnlineTranslator::*parseMethod)(), const QString &text = {}, int chunkIndex = -1);
+    void buildTranslitState(QState *parent, QString QTranslationResultData::*text, Language QTranslationResultData::*language, QString QTranslationResultData::*translit);
+
+    // Helper functions for dictionaries
+    bool applyCachedDictionary();
+    void applyDictionary(const QMap<QString, QVector<QOption>> &translationOptions, const QMap<QString, QVector<QExample>> &examples, const QString &transcription);
+    void setDictionaryError(const QString &errorString);
+
+    // Helper functions for requests
+    QString googleSections() const;
 
     // Helper functions for transliteration
-    void requestYandexTranslit(Language language);
+    void requestYandexTranslit(Language language, QString &translit);
     void parseYandexTranslit(QString &text);
 
     void resetData(TranslationError error = NoError, const QString &errorString = {});
+    void resetStateMachine();
+    QString engineUrl(Engine engine) const;
+    void preconnectToHost(const QUrl &url);
+
+    // Helper functions for time measurements
+    QTranslationTimings::Stage requestStage(void (QOnlineTranslator::*requestMethod)()) const;
+    void startMeasurement();
+    void finishMeasurement();
+    void startRequestMeasurement();
+    void measureReply(QTranslationTimings::Stage stage, int chunkIndex);
+    void startParseMeasurement(QTranslationTimings::Stage stage);
+    void finishParseMeasurement(QTranslationTimings::Stage stage);
+    QTranslationTimings::Stage rootStage() const;
+    QTranslationSpan createSpan(int id, QTranslationTimings::Stage stage = QTranslationTimings::Translation, int chunkIndex = -1) const;
 
     // Check for service support
     static bool isSupportTranslit(Engine engine, Language lang);
@@ -576,19 +847,88 @@ private:
     static QString languageApiCode(Engine engine, Language lang);
     static Language language(Engine engine, const QString &langCode);
     static int getSplitIndex(const QString &untranslatedText, int limit);
+    static int getEncodedLimit(const QString &text, int limit, int encodedLimit);
     static bool isContainsSpace(const QString &text);
     static void addSpaceBetweenParts(QString &text);
 
-    static const QMap<Language, QString> s_genericLanguageCodes;
+    // Language codes are stored in constant tables that are built at compile time
+    static constexpr size_t s_languagesCount = Zulu + 1;
+
+    struct LanguageCode {
+        Language language;
+        std::u16string_view code;
+    };
+
+    template<size_t N>
+    struct LanguageCodesTable {
+        std::array<std::u16string_view, s_languagesCount> codes; // Indexed by language
+        std::array<LanguageCode, s_languagesCount + N> index; // Sorted by code for binary search
+    };
+
+    template<size_t N>
+    static constexpr LanguageCodesTable<N> makeLanguageCodes(const std::array<LanguageCode, N> &exceptions);
+    template<size_t N>
+    static QString findLanguageCode(const LanguageCodesTable<N> &table, Language lang);
+    template<size_t N>
+    static Language findLanguage(const LanguageCodesTable<N> &table, const QString &langCode);
+
+    static const std::u16string_view s_genericLanguageCodes[];
+    static const LanguageCodesTable<0> s_genericLanguageCodesTable;
 
     // Engines have some language codes exceptions
-    static const QMap<Language, QString> s_googleLanguageCodes;
-    static const QMap<Language, QString> s_yandexLanguageCodes;
-    static const QMap<Language, QString> s_bingLanguageCodes;
-    static const QMap<Language, QString> s_lingvaLanguageCodes;
+    static const LanguageCodesTable<1> s_googleLanguageCodes;
+    static const LanguageCodesTable<2> s_yandexLanguageCodes;
+    static const LanguageCodesTable<6> s_bingLanguageCodes;
+    static const LanguageCodesTable<2> s_lingvaLanguageCodes;
+
+    // Set of languages that is built at compile time to check engines support
+    class LanguageSet
+    {
+    public:
+        constexpr LanguageSet() = default;
+        constexpr LanguageSet(std::initializer_list<Language> languages)
+        {
+            for (Language lang : languages)
+                m_bits[lang / 64] |= quint64(1) << (lang % 64);
+        }
+
+        static constexpr LanguageSet all()
+        {
+            LanguageSet set;
+            for (size_t lang = 0; lang < s_languagesCount; ++lang)
+                set.m_bits[lang / 64] |= quint64(1) << (lang % 64);
+            return set;
+        }
+
+        constexpr LanguageSet operator-(const LanguageSet &other) const
+        {
+            LanguageSet set;
+            for (size_t i = 0; i < m_bits.size(); ++i)
+                set.m_bits[i] = m_bits[i] & ~other.m_bits[i];
+            return set;
+        }
+
+        constexpr bool contains(Language lang) const
+        {
+            if (lang == NoLanguage)
+                return false;
+            return m_bits[lang / 64] & (quint64(1) << (lang % 64));
+        }
+
+    private:
+        std::array<quint64, (s_languagesCount + 63) / 64> m_bits{};
+    };
 
-    // Yandex require a random UUID to be generated
-    static inline QByteArray s_yandexUcid = QUuid::createUuid().toByteArray(QUuid::Id128);
+    static const LanguageSet s_googleLanguages;
+    static const LanguageSet s_yandexLanguages;
+    static const LanguageSet s_bingLanguages;
+    static const LanguageSet s_libreTranslateLanguages;
+    static const LanguageSet s_translationLanguages[];
+    static const LanguageSet s_translitLanguages[];
+
+    // Yandex require a random UUID to be generated, it's created on first use
+    static const QByteArray &yandexUcid();
+    static inline QByteArray s_yandexUcid;
 
     // Credentials that is parsed from the web version to receive the translation using the API
     static inline QByteArray s_bingKey;
@@ -596,6 +936,12 @@ private:
     static inline QString s_bingIg;
     static inline QString s_bingIid;
 
+    // Default engines URLs
+    static constexpr char s_googleUrl[] = "https://translate.googleapis.com";
+    static constexpr char s_yandexUrl[] = "https://translate.yandex.net";
+    static constexpr char s_yandexDictionaryUrl[] = "https://dictionary.yandex.net";
+    static constexpr char s_bingUrl[] = "https://www.bing.com";
+
     // This properties used to store unseful information in states
     static constexpr char s_textProperty[] = "Text";
 
@@ -607,37 +953,109 @@ private:
     static constexpr int s_bingTranslateLimit = 5001;
     static constexpr int s_libreTranslateLimit = 120;
 
+    // Streaming translation reads the input by parts of this size
+    static constexpr int s_streamSegmentLimit = 5000;
+
+    // Incremental translation splits the text into smaller parts to resend less
+    static constexpr int s_incrementalSegmentLimit = 500;
+
+    // Lingva accepts text only as a part of the URL, so the percent-encoded text is also limited to avoid "414 URI Too Long"
+    static constexpr int s_lingvaUrlLimit = 6000;
+
+    // Offline detection is used only with this confidence, otherwise the engine detects the language
+    static constexpr qreal s_offlineDetectionConfidence = 0.5;
+
     QStateMachine *m_stateMachine;
     QNetworkAccessManager *m_networkManager;
     QPointer<QNetworkReply> m_currentReply;
 
-    Language m_sourceLang = NoLanguage;
-    Language m_translationLang = NoLanguage;
+    // Data of the last translation, shared with the objects returned by result()
+    QSharedDataPointer<QTranslationResultData> m_result;
+
     Language m_uiLang = NoLanguage;
-    TranslationError m_error = NoError;
 
-    QString m_source;
-    QString m_sourceTranslit;
-    QString m_sourceTranscription;
-    QString m_translation;
-    QString m_translationTranslit;
-    QString m_errorString;
+    // Engines URLs, can be changed to use a proxy or a local stand-in
+    QString m_googleUrl = s_googleUrl;
+    QString m_yandexUrl = s_yandexUrl;
+    QString m_yandexDictionaryUrl = s_yandexDictionaryUrl;
+    QString m_bingUrl = s_bingUrl;
 
     // Self-hosted engines settings
     QByteArray m_libreApiKey; // Can be empty, since free instances ignores api_key param
     QString m_libreUrl;
     QString m_lingvaUrl;
 
-    QMap<QString, QVector<QOption>> m_translationOptions;
-    QMap<QString, QVector<QExample>> m_examples;
-
     bool m_sourceTranslitEnabled = true;
     bool m_translationTranslitEnabled = true;
     bool m_sourceTranscriptionEnabled = true;
     bool m_translationOptionsEnabled = true;
     bool m_examplesEnabled = true;
+    bool m_offlineLanguageDetectionEnabled = false;
+    bool m_lazyDictionaryEnabled = false;
 
     bool m_onlyDetectLanguage = false;
+
+    // Lazy dictionary state
+    bool m_dictionaryPending = false;
+    bool m_dictionaryRequested = false;
+    bool m_fetchingDictionary = false;
+
+    // Streaming translation state
+    bool m_streaming = false;
+    bool m_streamSpaceNeeded = false;
+    QPointer<QIODevice> m_streamInput;
+    QPointer<QIODevice> m_streamOutput;
+    QString m_streamBuffer;
+    QByteArray m_streamIncompleteBytes;
+
+    // Incremental translation state
+    struct Segment {
+        QString source;
+        QString translation;
+    };
+
+    struct IncrementalParameters {
+        Engine engine = Google;
+        Language translationLang = NoLanguage;
+        Language sourceLang = NoLanguage;
+        Language uiLang = NoLanguage;
+
+        bool operator!=(const IncrementalParameters &other) const
+        {
+            return engine != other.engine || translationLang != other.translationLang || sourceLang != other.sourceLang || uiLang != other.uiLang;
+        }
+    };
+
+    bool m_incremental = false;
+    QString m_incrementalSource;
+    QVector<Segment> m_segments;
+    QVector<Segment> m_changedSegments;
+    IncrementalParameters m_segmentsParameters;
+    Language m_segmentsSourceLang = NoLanguage;
+    int m_unchangedPrefixSize = 0;
+    int m_unchangedSuffixSize = 0;
+
+    // Split translation state to report its parts
+    int m_translationChunksCount = 0;
+    int m_translationChunkStart = 0;
+
+    // Measurements of the current request in nanoseconds since the translation start
+    QTranslationTimings m_timings;
+    QElapsedTimer m_timer;
+    qint64 m_requestStart = 0;
+    qint64 m_responseStart = -1;
+    qint64 m_parseStart = 0;
+    qint64 m_requestBytesSent = 0;
+    QSharedPointer<QLatencyHistogram> m_latencyHistogram;
+
+    // Spans are created only if a tracer is set
+    QTranslationTracer *m_tracer = nullptr;
+    int m_lastSpanId = 0;
+    int m_requestSpanId = 0;
+    int m_requestChunkIndex = -1;
+    int m_parseSpanId = 0;
+
+    QDictionaryCache *m_dictionaryCache = nullptr;
 };
 
 #endif // QONLINETRANSLATOR_H
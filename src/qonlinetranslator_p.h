@@ -0,0 +1,136 @@
+/*
+ *  Copyright © 2018-2023 Hennadii Chernyshchyk <genaloner@gmail.com>
+ *
+ *  This file is part of QOnlineTranslator.
+ *
+ *  QOnlineTranslator is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  QOnlineTranslator is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with QOnlineTranslator. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef QONLINETRANSLATOR_P_H
+#define QONLINETRANSLATOR_P_H
+
+#include "qonlinetranslator.h"
+#include "qtranslationresult.h"
+
+#include <QNetworkReply>
+
+/**
+ * @brief Internal access to QOnlineTranslator
+ *
+ * Exposes the helpers and the response parsers to measure them in isolation.
+ * Not a part of the public API, used by the benchmarks and may change without notice.
+ */
+class QOnlineTranslatorPrivateAccess
+{
+public:
+    static constexpr int s_googleTranslateLimit = QOnlineTranslator::s_googleTranslateLimit;
+
+    static int getSplitIndex(const QString &untranslatedText, int limit)
+    {
+        return QOnlineTranslator::getSplitIndex(untranslatedText, limit);
+    }
+
+    static QString languageApiCode(QOnlineTranslator::Engine engine, QOnlineTranslator::Language lang)
+    {
+        return QOnlineTranslator::languageApiCode(engine, lang);
+    }
+
+    static QOnlineTranslator::Language language(QOnlineTranslator::Engine engine, const QString &langCode)
+    {
+        return QOnlineTranslator::language(engine, langCode);
+    }
+
+    /**
+     * @brief Data of the last translation that parsers fill
+     *
+     * @param translator translator
+     * @return reference to the data, valid until the next call of QOnlineTranslator::takeResult()
+     */
+    static QTranslationResultData &resultData(QOnlineTranslator &translator)
+    {
+        return *translator.m_result;
+    }
+
+    static void setUiLanguage(QOnlineTranslator &translator, QOnlineTranslator::Language lang)
+    {
+        translator.m_uiLang = lang;
+    }
+
+    /**
+     * @brief Google response sections that the translator requests for the current settings and source text
+     *
+     * @param translator translator
+     * @return `dt=` query items
+     */
+    static QString googleSections(const QOnlineTranslator &translator)
+    {
+        return translator.googleSections();
+    }
+
+    /**
+     * @brief Check if response of the endpoint can be parsed with parseReply()
+     *
+     * @param endpoint endpoint name as returned by MockEngineServer::endpointName()
+     * @return `true` if there is a parser for the endpoint
+     */
+    static bool canParse(const QString &endpoint)
+    {
+        return parseMethod(endpoint) != nullptr;
+    }
+
+    /**
+     * @brief Parse reply as a response of the endpoint
+     *
+     * Clears results of the previous parsing, but keeps the source text and languages.
+     * The reply is not deleted.
+     *
+     * @param translator translator to fill
+     * @param endpoint endpoint name as returned by MockEngineServer::endpointName()
+     * @param reply finished reply with the response
+     */
+    static void parseReply(QOnlineTranslator &translator, const QString &endpoint, QNetworkReply *reply)
+    {
+        translator.resetData();
+        translator.m_currentReply = reply;
+        (translator.*parseMethod(endpoint))();
+    }
+
+private:
+    static void (QOnlineTranslator::*parseMethod(const QString &endpoint))()
+    {
+        if (endpoint == QLatin1String("google-translate"))
+            return &QOnlineTranslator::parseGoogleTranslate;
+        if (endpoint == QLatin1String("yandex-translate"))
+            return &QOnlineTranslator::parseYandexTranslate;
+        if (endpoint == QLatin1String("yandex-translit"))
+            return &QOnlineTranslator::parseYandexTranslationTranslit;
+        if (endpoint == QLatin1String("yandex-dictionary"))
+            return &QOnlineTranslator::parseYandexDictionary;
+        if (endpoint == QLatin1String("bing-credentials"))
+            return &QOnlineTranslator::parseBingCredentials;
+        if (endpoint == QLatin1String("bing-translate"))
+            return &QOnlineTranslator::parseBingTranslate;
+        if (endpoint == QLatin1String("bing-dictionary"))
+            return &QOnlineTranslator::parseBingDictionary;
+        if (endpoint == QLatin1String("libre-detect"))
+            return &QOnlineTranslator::parseLibreLangDetection;
+        if (endpoint == QLatin1String("libre-translate"))
+            return &QOnlineTranslator::parseLibreTranslate;
+        if (endpoint == QLatin1String("lingva-translate"))
+            return &QOnlineTranslator::parseLingvaTranslate;
+        return nullptr;
+    }
+};
+
+#endif // QONLINETRANSLATOR_P_H
@@ -19,47 +19,47 @@
 
 #include "qonlinetts.h"
 
+#include "qpercentencoder.h"
+
 #include <QMetaEnum>
 #include <QUrl>
 
-const QMap<QOnlineTts::Emotion, QString> QOnlineTts::s_emotionCodes = {
-    {Neutral, QStringLiteral("neutral")},
-    {Good, QStringLiteral("good")},
-    {Evil, QStringLiteral("evil")}};
-
-const QMap<QOnlineTts::Voice, QString> QOnlineTts::s_voiceCodes = {
-    {Zahar, QStringLiteral("zahar")},
-    {Ermil, QStringLiteral("ermil")},
-    {Jane, QStringLiteral("jane")},
-    {Oksana, QStringLiteral("oksana")},
-    {Alyss, QStringLiteral("alyss")},
-    {Omazh, QStringLiteral("omazh")}};
-
-const QMap<QPair<QOnlineTranslator::Language, QLocale::Country>, QString> QOnlineTts::s_regionCodes = {
-    {{QOnlineTranslator::Bengali, QLocale::Bangladesh}, QStringLiteral("bn-BD")},
-    {{QOnlineTranslator::Bengali, QLocale::India}, QStringLiteral("bn-IN")},
-    {{QOnlineTranslator::SimplifiedChinese, QLocale::China}, QStringLiteral("cmn-Hans-CN")},
-    {{QOnlineTranslator::English, QLocale::Australia}, QStringLiteral("en-AU")},
-    {{QOnlineTranslator::English, QLocale::India}, QStringLiteral("en-IN")},
-    {{QOnlineTranslator::English, QLocale::UnitedKingdom}, QStringLiteral("en-GB")},
-    {{QOnlineTranslator::English, QLocale::UnitedStates}, QStringLiteral("en-US")},
-    {{QOnlineTranslator::French, QLocale::Canada}, QStringLiteral("fr-CA")},
-    {{QOnlineTranslator::French, QLocale::France}, QStringLiteral("fr-FR")},
-    {{QOnlineTranslator::German, QLocale::Germany}, QStringLiteral("de-DE")},
-    {{QOnlineTranslator::Portuguese, QLocale::Brazil}, QStringLiteral("pt-BR")},
-    {{QOnlineTranslator::Spanish, QLocale::Spain}, QStringLiteral("es-ES")},
-    {{QOnlineTranslator::Spanish, QLocale::UnitedStates}, QStringLiteral("es-US")},
-    {{QOnlineTranslator::Tamil, QLocale::India}, QStringLiteral("ta-IN")}};
-
-const QMap<QOnlineTranslator::Language, QList<QLocale::Country>> QOnlineTts::s_validRegions = {
-    {QOnlineTranslator::Bengali, {QLocale::Bangladesh, QLocale::India}},
-    {QOnlineTranslator::SimplifiedChinese, {QLocale::China}},
-    {QOnlineTranslator::English, {QLocale::Australia, QLocale::India, QLocale::UnitedKingdom, QLocale::UnitedStates}},
-    {QOnlineTranslator::French, {QLocale::Canada, QLocale::France}},
-    {QOnlineTranslator::German, {QLocale::Germany}},
-    {QOnlineTranslator::Portuguese, {QLocale::Brazil}},
-    {QOnlineTranslator::Spanish, {QLocale::Spain, QLocale::UnitedStates}},
-    {QOnlineTranslator::Tamil, {QLocale::India}}};
+#include <iterator>
+
+// Indexed by emotion
+constexpr std::u16string_view QOnlineTts::s_emotionCodes[] = {
+    u"neutral",
+    u"good",
+    u"evil",
+};
+
+// Indexed by voice
+constexpr std::u16string_view QOnlineTts::s_voiceCodes[] = {
+    u"zahar",
+    u"ermil",
+    u"jane",
+    u"oksana",
+    u"alyss",
+    u"omazh",
+};
+
+// Grouped by language
+constexpr QOnlineTts::RegionCode QOnlineTts::s_regionCodes[] = {
+    {QOnlineTranslator::Bengali, QLocale::Bangladesh, u"bn-BD"},
+    {QOnlineTranslator::Bengali, QLocale::India, u"bn-IN"},
+    {QOnlineTranslator::SimplifiedChinese, QLocale::China, u"cmn-Hans-CN"},
+    {QOnlineTranslator::English, QLocale::Australia, u"en-AU"},
+    {QOnlineTranslator::English, QLocale::India, u"en-IN"},
+    {QOnlineTranslator::English, QLocale::UnitedKingdom, u"en-GB"},
+    {QOnlineTranslator::English, QLocale::UnitedStates, u"en-US"},
+    {QOnlineTranslator::French, QLocale::Canada, u"fr-CA"},
+    {QOnlineTranslator::French, QLocale::France, u"fr-FR"},
+    {QOnlineTranslator::German, QLocale::Germany, u"de-DE"},
+    {QOnlineTranslator::Portuguese, QLocale::Brazil, u"pt-BR"},
+    {QOnlineTranslator::Spanish, QLocale::Spain, u"es-ES"},
+    {QOnlineTranslator::Spanish, QLocale::UnitedStates, u"es-US"},
+    {QOnlineTranslator::Tamil, QLocale::India, u"ta-IN"},
+};
 
 QOnlineTts::QOnlineTts(QObject *parent)
     : QObject(parent)
@@ -86,15 +86,18 @@ void QOnlineTts::generateUrls(const QString &text, QOnlineTranslator::Engine eng
         if (langString.isNull())
             return;
 
+        // Common part of the API URLs, the buffer is reused for all parts
+        QByteArray apiUrl = "https://translate.googleapis.com/translate_tts?ie=UTF-8&client=gtx&tl=" + langString.toUtf8() + "&q=";
+        const int prefixSize = apiUrl.size();
+
         // Google has a limit of characters per tts request. If the query is larger, then it should be splited into several
         while (!unparsedText.isEmpty()) {
             const int splitIndex = QOnlineTranslator::getSplitIndex(unparsedText, s_googleTtsLimit); // Split the part by special symbol
 
             // Generate URL API for add it to the playlist
-            QUrl apiUrl(QStringLiteral("https://translate.googleapis.com/translate_tts"));
-            const QString query = QStringLiteral("ie=UTF-8&client=gtx&tl=%1&q=%2").arg(langString, QString(QUrl::toPercentEncoding(unparsedText.left(splitIndex))));
-            apiUrl.setQuery(query);
-            m_media.append(apiUrl);
+            apiUrl.resize(prefixSize);
+            QPercentEncoder::append(apiUrl, unparsedText.constData(), splitIndex);
+            m_media.append(QUrl::fromEncoded(apiUrl));
 
             // Remove the said part from the next saying
             unparsedText = unparsedText.mid(splitIndex);
@@ -114,16 +117,20 @@ void QOnlineTts::generateUrls(const QString &text, QOnlineTranslator::Engine eng
         if (emotionString.isNull())
             return;
 
+        // Common parts of the API URLs, the buffer is reused for all parts
+        QByteArray apiUrl = "https://tts.voicetech.yandex.net/tts?text=";
+        const int prefixSize = apiUrl.size();
+        const QByteArray suffix = QStringLiteral("&lang=%1&speaker=%2&emotion=%3&format=mp3").arg(langString, voiceString, emotionString).toUtf8();
+
         // Yandex has a limit of characters per tts request. If the query is larger, then it should be splited into several
         while (!unparsedText.isEmpty()) {
             const int splitIndex = QOnlineTranslator::getSplitIndex(unparsedText, s_yandexTtsLimit); // Split the part by special symbol
 
             // Generate URL API for add it to the playlist
-            QUrl apiUrl(QStringLiteral("https://tts.voicetech.yandex.net/tts"));
-            const QString query = QStringLiteral("text=%1&lang=%2&speaker=%3&emotion=%4&format=mp3")
-                                      .arg(QUrl::toPercentEncoding(unparsedText.left(splitIndex)), langString, voiceString, emotionString);
-            apiUrl.setQuery(query);
-            m_media.append(apiUrl);
+            apiUrl.resize(prefixSize);
+            QPercentEncoder::append(apiUrl, unparsedText.constData(), splitIndex);
+            apiUrl += suffix;
+            m_media.append(QUrl::fromEncoded(apiUrl));
 
             // Remove the said part from the next saying
             unparsedText = unparsedText.mid(splitIndex);
@@ -161,37 +168,84 @@ QOnlineTts::TtsError QOnlineTts::error() const
 
 QString QOnlineTts::voiceCode(Voice voice)
 {
-    return s_voiceCodes.value(voice);
+    if (voice == NoVoice)
+        return {};
+
+    return codeString(s_voiceCodes[voice]);
 }
 
 QString QOnlineTts::regionCode(QOnlineTranslator::Language language, QLocale::Country region)
 {
-    return s_regionCodes.value({language, region}, QOnlineTranslator::languageApiCode(QOnlineTranslator::Google, language));
+    for (const RegionCode &regionCode : s_regionCodes) {
+        if (regionCode.language == language && regionCode.region == region)
+            return codeString(regionCode.code);
+    }
+
+    return QOnlineTranslator::languageApiCode(QOnlineTranslator::Google, language);
 }
 
 QString QOnlineTts::emotionCode(Emotion emotion)
 {
-    return s_emotionCodes.value(emotion);
+    if (emotion == NoEmotion)
+        return {};
+
+    return codeString(s_emotionCodes[emotion]);
 }
 
 QOnlineTts::Emotion QOnlineTts::emotion(const QString &emotionCode)
 {
-    return s_emotionCodes.key(emotionCode, NoEmotion);
+    const std::u16string_view code = codeView(emotionCode);
+    for (size_t i = 0; i < std::size(s_emotionCodes); ++i) {
+        if (s_emotionCodes[i] == code)
+            return static_cast<Emotion>(i);
+    }
+
+    return NoEmotion;
 }
 
 QOnlineTts::Voice QOnlineTts::voice(const QString &voiceCode)
 {
-    return s_voiceCodes.key(voiceCode, NoVoice);
+    const std::u16string_view code = codeView(voiceCode);
+    for (size_t i = 0; i < std::size(s_voiceCodes); ++i) {
+        if (s_voiceCodes[i] == code)
+            return static_cast<Voice>(i);
+    }
+
+    return NoVoice;
 }
 
 QPair<QOnlineTranslator::Language, QLocale::Country> QOnlineTts::region(const QString &regionCode)
 {
-    return s_regionCodes.key(regionCode, {QOnlineTranslator::NoLanguage, QLocale::AnyCountry});
+    const std::u16string_view code = codeView(regionCode);
+    for (const RegionCode &region : s_regionCodes) {
+        if (region.code == code)
+            return {region.language, region.region};
+    }
+
+    return {QOnlineTranslator::NoLanguage, QLocale::AnyCountry};
 }
 
 const QMap<QOnlineTranslator::Language, QList<QLocale::Country>> &QOnlineTts::validRegions()
 {
-    return s_validRegions;
+    // Built on first use from the codes table to avoid dynamic initialization on load
+    static const QMap<QOnlineTranslator::Language, QList<QLocale::Country>> validRegions = [] {
+        QMap<QOnlineTranslator::Language, QList<QLocale::Country>> regions;
+        for (const RegionCode &region : s_regionCodes)
+            regions[region.language].append(region.region);
+        return regions;
+    }();
+    return validRegions;
+}
+
+// Codes are stored in static memory, no need to copy them
+QString QOnlineTts::codeString(std::u16string_view code)
+{
+    return QString::fromRawData(reinterpret_cast<const QChar *>(code.data()), static_cast<int>(code.size()));
+}
+
+std::u16string_view QOnlineTts::codeView(const QString &code)
+{
+    return {reinterpret_cast<const char16_t *>(code.utf16()), static_cast<size_t>(code.size())};
 }
 
 void QOnlineTts::setError(TtsError error, const QString &errorString)
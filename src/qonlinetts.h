@@ -25,6 +25,8 @@
 #include <QLocale>
 #include <QMediaContent>
 
+#include <string_view>
+
 /**
  * @brief Provides TTS URL generation
  *
@@ -231,10 +233,19 @@ private:
     QString voiceApiCode(QOnlineTranslator::Engine engine, Voice voice);
     QString emotionApiCode(QOnlineTranslator::Engine engine, Emotion emotion);
 
-    static const QMap<Emotion, QString> s_emotionCodes;
-    static const QMap<Voice, QString> s_voiceCodes;
-    static const QMap<QPair<QOnlineTranslator::Language, QLocale::Country>, QString> s_regionCodes;
-    static const QMap<QOnlineTranslator::Language, QList<QLocale::Country>> s_validRegions;
+    static QString codeString(std::u16string_view code);
+    static std::u16string_view codeView(const QString &code);
+
+    // Codes are stored in constant tables to not require dynamic initialization
+    struct RegionCode {
+        QOnlineTranslator::Language language;
+        QLocale::Country region;
+        std::u16string_view code;
+    };
+
+    static const std::u16string_view s_emotionCodes[];
+    static const std::u16string_view s_voiceCodes[];
+    static const RegionCode s_regionCodes[];
 
     QMap<QOnlineTranslator::Language, QLocale::Country> m_regionPreferences;
 
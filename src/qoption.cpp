@@ -32,3 +32,14 @@ QJsonObject QOption::toJson() const
 
     return object;
 }
+
+QOption QOption::fromJson(const QJsonObject &object)
+{
+    QStringList translations;
+    const QJsonArray translationsArray = object.value(QStringLiteral("translations")).toArray();
+    translations.reserve(translationsArray.size());
+    for (const QJsonValue &translation : translationsArray)
+        translations.append(translation.toString());
+
+    return {object.value(QStringLiteral("word")).toString(), object.value(QStringLiteral("gender")).toString(), translations};
+}
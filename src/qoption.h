@@ -84,6 +84,14 @@ struct QOption {
      * @return JSON representation
      */
     QJsonObject toJson() const;
+
+    /**
+     * @brief Creates the object from JSON
+     *
+     * @param object JSON representation created by toJson()
+     * @return translation options
+     */
+    static QOption fromJson(const QJsonObject &object);
 };
 
 #endif // QOPTION_H
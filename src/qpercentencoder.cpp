@@ -0,0 +1,141 @@
+/*
+ *  Copyright © 2018-2023 Hennadii Chernyshchyk <genaloner@gmail.com>
+ *
+ *  This file is part of QOnlineTranslator.
+ *
+ *  QOnlineTranslator is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  QOnlineTranslator is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with QOnlineTranslator. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "qpercentencoder.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define QPERCENTENCODER_SSE2
+#endif
+
+void QPercentEncoder::append(QByteArray &buffer, const QString &text)
+{
+    append(buffer, text.constData(), text.size());
+}
+
+void QPercentEncoder::append(QByteArray &buffer, const QChar *data, int size)
+{
+    if (size == 0)
+        return;
+
+    // Reserve the worst case and shrink to the written size (capacity is kept for the next append)
+    const int oldSize = buffer.size();
+    buffer.resize(oldSize + size * s_maxEncodedUnitSize);
+    char *const begin = buffer.data();
+    char *output = begin + oldSize;
+
+    const auto *units = reinterpret_cast<const char16_t *>(data);
+    int index = 0;
+    while (index < size) {
+#ifdef QPERCENTENCODER_SSE2
+        if (size - index >= 8) {
+            const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(units + index));
+
+            // Signed comparisons are fine since code units above 0x7FFF are negative and fall out of all ranges
+            const auto inRange = [block](char16_t first, char16_t last) {
+                return _mm_and_si128(_mm_cmpgt_epi16(block, _mm_set1_epi16(static_cast<short>(first - 1))),
+                                     _mm_cmplt_epi16(block, _mm_set1_epi16(static_cast<short>(last + 1))));
+            };
+            __m128i unreserved = _mm_or_si128(inRange(u'a', u'z'), inRange(u'A', u'Z'));
+            unreserved = _mm_or_si128(unreserved, inRange(u'-', u'.'));
+            unreserved = _mm_or_si128(unreserved, inRange(u'0', u'9'));
+            unreserved = _mm_or_si128(unreserved, _mm_cmpeq_epi16(block, _mm_set1_epi16(u'_')));
+            unreserved = _mm_or_si128(unreserved, _mm_cmpeq_epi16(block, _mm_set1_epi16(u'~')));
+
+            if (_mm_movemask_epi8(unreserved) == 0xFFFF) {
+                // All code units are ASCII, narrow them into bytes
+                _mm_storel_epi64(reinterpret_cast<__m128i *>(output), _mm_packus_epi16(block, block));
+                output += 8;
+                index += 8;
+                continue;
+            }
+
+            // Encode the block one by one without checking every position again (surrogate pair can cross the block end)
+            const int blockEnd = index + 8;
+            while (index < blockEnd)
+                index = encodeCharacter(units, index, size, output);
+            continue;
+        }
+#endif
+        index = encodeCharacter(units, index, size, output);
+    }
+
+    buffer.resize(static_cast<int>(output - begin));
+}
+
+QByteArray QPercentEncoder::encode(const QString &text)
+{
+    QByteArray buffer;
+    append(buffer, text);
+    return buffer;
+}
+
+int QPercentEncoder::encodeCharacter(const char16_t *data, int index, int size, char *&output)
+{
+    char32_t character = data[index];
+    if (character < 0x80) {
+        if (isUnreserved(static_cast<char16_t>(character)))
+            *output++ = static_cast<char>(character);
+        else
+            writeEncoded(output, static_cast<uchar>(character));
+        return index + 1;
+    }
+
+    if (character < 0x800) {
+        writeEncoded(output, static_cast<uchar>(0xC0 | (character >> 6)));
+        writeEncoded(output, static_cast<uchar>(0x80 | (character & 0x3F)));
+        return index + 1;
+    }
+
+    if (QChar::isSurrogate(character)) {
+        if (QChar::isHighSurrogate(character) && index + 1 < size && QChar::isLowSurrogate(data[index + 1])) {
+            character = QChar::surrogateToUcs4(static_cast<char16_t>(character), data[index + 1]);
+            writeEncoded(output, static_cast<uchar>(0xF0 | (character >> 18)));
+            writeEncoded(output, static_cast<uchar>(0x80 | ((character >> 12) & 0x3F)));
+            writeEncoded(output, static_cast<uchar>(0x80 | ((character >> 6) & 0x3F)));
+            writeEncoded(output, static_cast<uchar>(0x80 | (character & 0x3F)));
+            return index + 2;
+        }
+
+        // Unpaired surrogate, QString::toUtf8() replaces it with '?'
+        writeEncoded(output, '?');
+        return index + 1;
+    }
+
+    writeEncoded(output, static_cast<uchar>(0xE0 | (character >> 12)));
+    writeEncoded(output, static_cast<uchar>(0x80 | ((character >> 6) & 0x3F)));
+    writeEncoded(output, static_cast<uchar>(0x80 | (character & 0x3F)));
+    return index + 1;
+}
+
+void QPercentEncoder::writeEncoded(char *&output, uchar byte)
+{
+    output[0] = '%';
+    output[1] = s_hexDigits[byte >> 4];
+    output[2] = s_hexDigits[byte & 0xF];
+    output += 3;
+}
+
+bool QPercentEncoder::isUnreserved(char16_t character)
+{
+    return (character >= u'a' && character <= u'z')
+        || (character >= u'A' && character <= u'Z')
+        || (character >= u'0' && character <= u'9')
+        || character == u'-' || character == u'.' || character == u'_' || character == u'~';
+}
@@ -0,0 +1,81 @@
+/*
+ *  Copyright © 2018-2023 Hennadii Chernyshchyk <genaloner@gmail.com>
+ *
+ *  This file is part of QOnlineTranslator.
+ *
+ *  QOnlineTranslator is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  QOnlineTranslator is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with QOnlineTranslator. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef QPERCENTENCODER_H
+#define QPERCENTENCODER_H
+
+#include <QByteArray>
+#include <QString>
+
+/**
+ * @brief Converts text into percent-encoded UTF-8
+ *
+ * Produces the same output as `QUrl::toPercentEncoding(text)`, but encodes UTF-16 directly in a single pass
+ * without the intermediate UTF-8 array and appends the result to the existing buffer,
+ * so request payloads and queries can be built without temporary copies.
+ * Runs of unreserved ASCII characters are copied using SSE2 where available.
+ * Unpaired surrogates are encoded as `?` (`%3F`), like `QString::toUtf8()` does.
+ *
+ * Example:
+ * @code
+ * QByteArray postData = "q=";
+ * QPercentEncoder::append(postData, text);
+ * postData += "&tl=en";
+ * @endcode
+ */
+class QPercentEncoder
+{
+public:
+    /**
+     * @brief Append percent-encoded text to the buffer
+     *
+     * @param buffer buffer to append to
+     * @param text text to encode
+     */
+    static void append(QByteArray &buffer, const QString &text);
+
+    /**
+     * @brief Append percent-encoded text to the buffer
+     *
+     * @param buffer buffer to append to
+     * @param data UTF-16 text
+     * @param size number of code units
+     */
+    static void append(QByteArray &buffer, const QChar *data, int size);
+
+    /**
+     * @brief Percent-encode text
+     *
+     * @param text text to encode
+     * @return percent-encoded UTF-8
+     */
+    static QByteArray encode(const QString &text);
+
+private:
+    static int encodeCharacter(const char16_t *data, int index, int size, char *&output);
+    static void writeEncoded(char *&output, uchar byte);
+    static bool isUnreserved(char16_t character);
+
+    // One UTF-16 code unit takes up to 3 UTF-8 bytes, each byte takes up to 3 characters
+    static constexpr int s_maxEncodedUnitSize = 9;
+
+    static constexpr char s_hexDigits[] = "0123456789ABCDEF";
+};
+
+#endif // QPERCENTENCODER_H
@@ -0,0 +1,341 @@
+/*
+ *  Copyright © 2018-2023 Hennadii Chernyshchyk <genaloner@gmail.com>
+ *
+ *  This file is part of QOnlineTranslator.
+ *
+ *  QOnlineTranslator is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  QOnlineTranslator is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with QOnlineTranslator. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "qscripthistogram.h"
+
+#include <QtAlgorithms>
+
+#include <algorithm>
+#include <iterator>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define QSCRIPTHISTOGRAM_SSE2
+// AVX2 version is compiled using the target attribute and selected at runtime
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define QSCRIPTHISTOGRAM_AVX2
+#endif
+#endif
+
+constexpr QScriptHistogram::Range QScriptHistogram::s_ranges[] = {
+    // ASCII
+    {0x09, 0x0D, Whitespace},
+    {0x20, 0x20, Whitespace},
+    {0x21, 0x2F, Punctuation},
+    {0x30, 0x39, Digit},
+    {0x3A, 0x40, Punctuation},
+    {0x41, 0x5A, Latin},
+    {0x5B, 0x60, Punctuation},
+    {0x61, 0x7A, Latin},
+    {0x7B, 0x7E, Punctuation},
+
+    // Latin-1 and other blocks
+    {0x85, 0x85, Whitespace},
+    {0xA0, 0xA0, Whitespace},
+    {0xA1, 0xBF, Punctuation},
+    {0xC0, 0xD6, Latin},
+    {0xD7, 0xD7, Punctuation},
+    {0xD8, 0xF6, Latin},
+    {0xF7, 0xF7, Punctuation},
+    {0xF8, 0x024F, Latin},
+    {0x0400, 0x052F, Cyrillic},
+    {0x0600, 0x06FF, Arabic},
+    {0x0750, 0x077F, Arabic},
+    {0x1680, 0x1680, Whitespace},
+    {0x1E00, 0x1EFF, Latin},
+    {0x2000, 0x200A, Whitespace},
+    {0x2010, 0x2027, Punctuation},
+    {0x2028, 0x2029, Whitespace},
+    {0x202F, 0x202F, Whitespace},
+    {0x2030, 0x205E, Punctuation},
+    {0x205F, 0x205F, Whitespace},
+    {0x3000, 0x3000, Whitespace},
+    {0x3001, 0x303F, Punctuation},
+    {0x3040, 0x30FF, Cjk},
+    {0x3400, 0x4DBF, Cjk},
+    {0x4E00, 0x9FFF, Cjk},
+    {0xAC00, 0xD7AF, Cjk},
+    {0xF900, 0xFAFF, Cjk},
+    {0xFB50, 0xFDFF, Arabic},
+    {0xFE70, 0xFEFF, Arabic},
+    {0xFF01, 0xFF0F, Punctuation},
+    {0xFF10, 0xFF19, Digit},
+    {0xFF1A, 0xFF20, Punctuation},
+};
+
+QScriptHistogram::QScriptHistogram(const QString &text)
+    : QScriptHistogram(text.constData(), text.size())
+{
+}
+
+QScriptHistogram::QScriptHistogram(const QChar *data, int size)
+    : m_size(qMax(size, 0))
+{
+    const auto *characters = reinterpret_cast<const char16_t *>(data);
+
+    // Vector versions process whole blocks, the rest is processed one by one
+    int processed = 0;
+#if defined(QSCRIPTHISTOGRAM_AVX2)
+    static const bool hasAvx2 = __builtin_cpu_supports("avx2");
+    processed = hasAvx2 ? countAvx2(characters, m_size) : countSse2(characters, m_size);
+#elif defined(QSCRIPTHISTOGRAM_SSE2)
+    processed = countSse2(characters, m_size);
+#endif
+    for (int i = processed; i < m_size; ++i)
+        ++m_counts[category(characters[i])];
+
+    // Ranges do not include characters of the Other category, so they are counted as the rest
+    int categorized = 0;
+    for (int category = 0; category < Other; ++category)
+        categorized += m_counts[category];
+    m_counts[Other] = m_size - categorized;
+}
+
+int QScriptHistogram::count(Category category) const
+{
+    return m_counts[category];
+}
+
+int QScriptHistogram::size() const
+{
+    return m_size;
+}
+
+bool QScriptHistogram::hasLetters() const
+{
+    return m_counts[Digit] + m_counts[Punctuation] + m_counts[Whitespace] != m_size;
+}
+
+#ifdef QSCRIPTHISTOGRAM_SSE2
+// Unsigned range check: (character - first) <= (last - first)
+static inline __m128i inRangeSse2(__m128i characters, char16_t first, char16_t last)
+{
+    const __m128i offset = _mm_sub_epi16(characters, _mm_set1_epi16(static_cast<short>(first)));
+    return _mm_cmpeq_epi16(_mm_subs_epu16(offset, _mm_set1_epi16(static_cast<short>(last - first))), _mm_setzero_si128());
+}
+
+int QScriptHistogram::countSse2(const char16_t *data, int size)
+{
+    constexpr int blockSize = sizeof(__m128i) / sizeof(char16_t);
+    const int blocksCount = size / blockSize;
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i allOnes = _mm_cmpeq_epi16(zero, zero);
+
+    int block = 0;
+    int uniformRange = -1; // Range that contains the whole previous block, text usually consists of a single script
+    while (block < blocksCount) {
+        // Each lane is increased at most by one per block, so the counters can't overflow during the batch
+        __m128i counters[CategoriesCount];
+        std::fill(std::begin(counters), std::end(counters), zero);
+        __m128i latin = zero;
+        __m128i digits = zero;
+        __m128i whitespaces = zero;
+        __m128i punctuation = zero;
+
+        for (const int batchEnd = qMin(blocksCount, block + s_batchBlocksCount); block < batchEnd; ++block) {
+            const __m128i characters = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + block * blockSize));
+
+            // ASCII is checked without the ranges table
+            if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(characters, _mm_set1_epi16(static_cast<short>(0xFF80))), zero)) == 0xFFFF) {
+                const __m128i isLatin = inRangeSse2(_mm_or_si128(characters, _mm_set1_epi16(0x20)), u'a', u'z');
+                const __m128i isDigit = inRangeSse2(characters, u'0', u'9');
+                const __m128i isWhitespace = _mm_or_si128(inRangeSse2(characters, 0x09, 0x0D), _mm_cmpeq_epi16(characters, _mm_set1_epi16(0x20)));
+                const __m128i isPrintable = inRangeSse2(characters, 0x21, 0x7E);
+                latin = _mm_sub_epi16(latin, isLatin);
+                digits = _mm_sub_epi16(digits, isDigit);
+                whitespaces = _mm_sub_epi16(whitespaces, isWhitespace);
+                punctuation = _mm_sub_epi16(punctuation, _mm_andnot_si128(_mm_or_si128(isLatin, isDigit), isPrintable));
+                continue;
+            }
+
+            if (uniformRange != -1) {
+                const Range &range = s_ranges[uniformRange];
+                if (_mm_movemask_epi8(inRangeSse2(characters, range.first, range.last)) == 0xFFFF) {
+                    counters[range.category] = _mm_sub_epi16(counters[range.category], allOnes);
+                    continue;
+                }
+                uniformRange = -1;
+            }
+
+            for (int i = s_asciiRangesCount; i < static_cast<int>(std::size(s_ranges)); ++i) {
+                const __m128i isInRange = inRangeSse2(characters, s_ranges[i].first, s_ranges[i].last);
+                const int mask = _mm_movemask_epi8(isInRange);
+                if (mask == 0)
+                    continue;
+
+                if (mask == 0xFFFF)
+                    uniformRange = i;
+                counters[s_ranges[i].category] = _mm_sub_epi16(counters[s_ranges[i].category], isInRange);
+            }
+
+            // ASCII characters of the mixed block
+            const __m128i isLatin = _mm_or_si128(inRangeSse2(characters, u'A', u'Z'), inRangeSse2(characters, u'a', u'z'));
+            const __m128i isDigit = inRangeSse2(characters, u'0', u'9');
+            const __m128i isWhitespace = _mm_or_si128(inRangeSse2(characters, 0x09, 0x0D), _mm_cmpeq_epi16(characters, _mm_set1_epi16(0x20)));
+            const __m128i isPrintable = inRangeSse2(characters, 0x21, 0x7E);
+            latin = _mm_sub_epi16(latin, isLatin);
+            digits = _mm_sub_epi16(digits, isDigit);
+            whitespaces = _mm_sub_epi16(whitespaces, isWhitespace);
+            punctuation = _mm_sub_epi16(punctuation, _mm_andnot_si128(_mm_or_si128(isLatin, isDigit), isPrintable));
+        }
+
+        counters[Latin] = _mm_add_epi16(counters[Latin], latin);
+        counters[Digit] = _mm_add_epi16(counters[Digit], digits);
+        counters[Whitespace] = _mm_add_epi16(counters[Whitespace], whitespaces);
+        counters[Punctuation] = _mm_add_epi16(counters[Punctuation], punctuation);
+        for (int category = 0; category < Other; ++category) {
+            const __m128i sums = _mm_add_epi32(_mm_unpacklo_epi16(counters[category], zero), _mm_unpackhi_epi16(counters[category], zero));
+            alignas(__m128i) qint32 lanes[blockSize / 2];
+            _mm_store_si128(reinterpret_cast<__m128i *>(lanes), sums);
+            for (qint32 lane : lanes)
+                m_counts[category] += lane;
+        }
+    }
+
+    return blocksCount * blockSize;
+}
+#endif
+
+#ifdef QSCRIPTHISTOGRAM_AVX2
+// Unsigned range check: (character - first) <= (last - first)
+__attribute__((target("avx2"))) static inline __m256i inRangeAvx2(__m256i characters, char16_t first, char16_t last)
+{
+    const __m256i offset = _mm256_sub_epi16(characters, _mm256_set1_epi16(static_cast<short>(first)));
+    return _mm256_cmpeq_epi16(_mm256_subs_epu16(offset, _mm256_set1_epi16(static_cast<short>(last - first))), _mm256_setzero_si256());
+}
+
+__attribute__((target("avx2"))) int QScriptHistogram::countAvx2(const char16_t *data, int size)
+{
+    constexpr int blockSize = sizeof(__m256i) / sizeof(char16_t);
+    const int blocksCount = size / blockSize;
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i allOnes = _mm256_cmpeq_epi16(zero, zero);
+
+    int block = 0;
+    int uniformRange = -1; // Range that contains the whole previous block, text usually consists of a single script
+    while (block < blocksCount) {
+        // Each lane is increased at most by one per block, so the counters can't overflow during the batch
+        __m256i counters[CategoriesCount];
+        std::fill(std::begin(counters), std::end(counters), zero);
+        __m256i latin = zero;
+        __m256i digits = zero;
+        __m256i whitespaces = zero;
+        __m256i punctuation = zero;
+
+        for (const int batchEnd = qMin(blocksCount, block + s_batchBlocksCount); block < batchEnd; ++block) {
+            const __m256i characters = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + block * blockSize));
+
+            // ASCII is checked without the ranges table
+            if (_mm256_movemask_epi8(_mm256_cmpeq_epi16(_mm256_and_si256(characters, _mm256_set1_epi16(static_cast<short>(0xFF80))), zero)) == -1) {
+                const __m256i isLatin = inRangeAvx2(_mm256_or_si256(characters, _mm256_set1_epi16(0x20)), u'a', u'z');
+                const __m256i isDigit = inRangeAvx2(characters, u'0', u'9');
+                const __m256i isWhitespace = _mm256_or_si256(inRangeAvx2(characters, 0x09, 0x0D), _mm256_cmpeq_epi16(characters, _mm256_set1_epi16(0x20)));
+                const __m256i isPrintable = inRangeAvx2(characters, 0x21, 0x7E);
+                latin = _mm256_sub_epi16(latin, isLatin);
+                digits = _mm256_sub_epi16(digits, isDigit);
+                whitespaces = _mm256_sub_epi16(whitespaces, isWhitespace);
+                punctuation = _mm256_sub_epi16(punctuation, _mm256_andnot_si256(_mm256_or_si256(isLatin, isDigit), isPrintable));
+                continue;
+            }
+
+            if (uniformRange != -1) {
+                const Range &range = s_ranges[uniformRange];
+                if (_mm256_movemask_epi8(inRangeAvx2(characters, range.first, range.last)) == -1) {
+                    counters[range.category] = _mm256_sub_epi16(counters[range.category], allOnes);
+                    continue;
+                }
+                uniformRange = -1;
+            }
+
+            for (int i = s_asciiRangesCount; i < static_cast<int>(std::size(s_ranges)); ++i) {
+                const __m256i isInRange = inRangeAvx2(characters, s_ranges[i].first, s_ranges[i].last);
+                const int mask = _mm256_movemask_epi8(isInRange);
+                if (mask == 0)
+                    continue;
+
+                if (mask == -1)
+                    uniformRange = i;
+                counters[s_ranges[i].category] = _mm256_sub_epi16(counters[s_ranges[i].category], isInRange);
+            }
+
+            // ASCII characters of the mixed block
+            const __m256i isLatin = _mm256_or_si256(inRangeAvx2(characters, u'A', u'Z'), inRangeAvx2(characters, u'a', u'z'));
+            const __m256i isDigit = inRangeAvx2(characters, u'0', u'9');
+            const __m256i isWhitespace = _mm256_or_si256(inRangeAvx2(characters, 0x09, 0x0D), _mm256_cmpeq_epi16(characters, _mm256_set1_epi16(0x20)));
+            const __m256i isPrintable = inRangeAvx2(characters, 0x21, 0x7E);
+            latin = _mm256_sub_epi16(latin, isLatin);
+            digits = _mm256_sub_epi16(digits, isDigit);
+            whitespaces = _mm256_sub_epi16(whitespaces, isWhitespace);
+            punctuation = _mm256_sub_epi16(punctuation, _mm256_andnot_si256(_mm256_or_si256(isLatin, isDigit), isPrintable));
+        }
+
+        counters[Latin] = _mm256_add_epi16(counters[Latin], latin);
+        counters[Digit] = _mm256_add_epi16(counters[Digit], digits);
+        counters[Whitespace] = _mm256_add_epi16(counters[Whitespace], whitespaces);
+        counters[Punctuation] = _mm256_add_epi16(counters[Punctuation], punctuation);
+        for (int category = 0; category < Other; ++category) {
+            const __m256i sums = _mm256_add_epi32(_mm256_unpacklo_epi16(counters[category], zero), _mm256_unpackhi_epi16(counters[category], zero));
+            alignas(__m256i) qint32 lanes[blockSize / 2];
+            _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), sums);
+            for (qint32 lane : lanes)
+                m_counts[category] += lane;
+        }
+    }
+
+    return blocksCount * blockSize;
+}
+#endif
+
+int QScriptHistogram::indexOfWhitespace(const QChar *data, int size)
+{
+    const auto *characters = reinterpret_cast<const char16_t *>(data);
+    int index = 0;
+#ifdef QSCRIPTHISTOGRAM_SSE2
+    // Skip blocks of printable ASCII at once, only the other characters can be whitespaces
+    constexpr int blockSize = sizeof(__m128i) / sizeof(char16_t);
+    for (; index + blockSize <= size; index += blockSize) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(characters + index));
+        auto candidates = static_cast<quint32>(~_mm_movemask_epi8(inRangeSse2(block, 0x21, 0x7E)) & 0xFFFF);
+        while (candidates != 0) {
+            const int lane = static_cast<int>(qCountTrailingZeroBits(candidates)) / 2;
+            if (category(characters[index + lane]) == Whitespace)
+                return index + lane;
+            candidates &= ~(3U << (lane * 2));
+        }
+    }
+#endif
+    for (; index < size; ++index) {
+        if (category(characters[index]) == Whitespace)
+            return index;
+    }
+
+    return -1;
+}
+
+QScriptHistogram::Category QScriptHistogram::category(char16_t character)
+{
+    // Ranges are sorted, so the search stops at the first range that ends after the character
+    for (const Range &range : s_ranges) {
+        if (character <= range.last)
+            return character >= range.first ? range.category : Other;
+    }
+
+    return Other;
+}
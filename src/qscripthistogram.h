@@ -0,0 +1,135 @@
+/*
+ *  Copyright © 2018-2023 Hennadii Chernyshchyk <genaloner@gmail.com>
+ *
+ *  This file is part of QOnlineTranslator.
+ *
+ *  QOnlineTranslator is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  QOnlineTranslator is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with QOnlineTranslator. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef QSCRIPTHISTOGRAM_H
+#define QSCRIPTHISTOGRAM_H
+
+#include <QString>
+
+#include <array>
+
+/**
+ * @brief Counts characters of the text by scripts and character classes
+ *
+ * The text is scanned as UTF-16 code units using SSE2 or AVX2 (selected at runtime) with a scalar fallback,
+ * so the counting is limited mostly by the memory bandwidth.
+ * Code units that do not belong to the listed categories (other scripts, symbols, control characters, surrogates)
+ * are counted as Other.
+ *
+ * Example:
+ * @code
+ * const QScriptHistogram histogram(text);
+ * if (histogram.count(QScriptHistogram::Cyrillic) > histogram.count(QScriptHistogram::Latin))
+ *     translator.translate(text, QOnlineTranslator::Yandex);
+ * @endcode
+ */
+class QScriptHistogram
+{
+public:
+    /**
+     * @brief Character category
+     */
+    enum Category {
+        Latin,
+        Cyrillic,
+        Cjk, ///< Han, kana and hangul
+        Arabic,
+        Digit, ///< ASCII and fullwidth digits
+        Punctuation, ///< Punctuation and common symbols
+        Whitespace, ///< Characters for which QChar::isSpace() returns `true`
+        Other,
+        CategoriesCount
+    };
+
+    /**
+     * @brief Create empty histogram
+     */
+    QScriptHistogram() = default;
+
+    /**
+     * @brief Count characters of the text
+     *
+     * @param text text to scan
+     */
+    explicit QScriptHistogram(const QString &text);
+
+    /**
+     * @brief Count characters of the text
+     *
+     * @param data UTF-16 text
+     * @param size number of code units
+     */
+    QScriptHistogram(const QChar *data, int size);
+
+    /**
+     * @brief Number of characters in the category
+     *
+     * @param category category
+     * @return number of UTF-16 code units
+     */
+    int count(Category category) const;
+
+    /**
+     * @brief Total number of characters
+     *
+     * @return number of UTF-16 code units
+     */
+    int size() const;
+
+    /**
+     * @brief Check if the text can contain letters
+     *
+     * @return `true` if the text contains something except digits, punctuation and whitespaces
+     */
+    bool hasLetters() const;
+
+    /**
+     * @brief Find the first whitespace in the text
+     *
+     * Stops at the first whitespace instead of counting the whole text.
+     *
+     * @param data UTF-16 text
+     * @param size number of code units
+     * @return index of the first code unit of the Whitespace category or -1 if there is none
+     */
+    static int indexOfWhitespace(const QChar *data, int size);
+
+private:
+    struct Range {
+        char16_t first;
+        char16_t last;
+        Category category;
+    };
+
+    int countSse2(const char16_t *data, int size);
+    int countAvx2(const char16_t *data, int size);
+    static Category category(char16_t character);
+
+    // Ranges are sorted, ASCII ones are placed first to be skipped by vector versions that check ASCII separately
+    static const Range s_ranges[];
+    static constexpr int s_asciiRangesCount = 9;
+
+    // Blocks count after which vector counters of 16-bit lanes are added to the totals
+    static constexpr int s_batchBlocksCount = 0xFFFF;
+
+    std::array<int, CategoriesCount> m_counts{};
+    int m_size = 0;
+};
+
+#endif // QSCRIPTHISTOGRAM_H
@@ -0,0 +1,161 @@
+/*
+ *  Copyright © 2018-2023 Hennadii Chernyshchyk <genaloner@gmail.com>
+ *
+ *  This file is part of QOnlineTranslator.
+ *
+ *  QOnlineTranslator is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  QOnlineTranslator is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with QOnlineTranslator. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "qtranslationmetrics.h"
+
+#include <QMetaEnum>
+
+#include <algorithm>
+
+QTranslationMetrics &QTranslationMetrics::instance()
+{
+    static QTranslationMetrics metrics;
+    return metrics;
+}
+
+void QTranslationMetrics::recordTranslation(QOnlineTranslator::Engine engine, QOnlineTranslator::TranslationError error, const QTranslationTimings &timings)
+{
+    QMutexLocker locker(&m_mutex);
+    EngineMetrics &metrics = m_engines[engine];
+    ++metrics.translations[error];
+
+    // Translations that were not started have nothing to measure
+    if (timings.requests() == 0)
+        return;
+
+    metrics.translationDuration.record(timings.total);
+    for (int stage = 0; stage < QTranslationTimings::StagesCount; ++stage) {
+        const QTranslationTimings::StageTimings &stageTimings = timings.stages[stage];
+        if (stageTimings.requests == 0)
+            continue;
+
+        metrics.stageDurations[stage].record(stageTimings.firstByteTime + stageTimings.downloadTime + stageTimings.parseTime);
+        metrics.requests[stage] += stageTimings.requests;
+        metrics.bytesSent += stageTimings.bytesSent;
+        metrics.bytesReceived += stageTimings.bytesReceived;
+    }
+}
+
+void QTranslationMetrics::recordCacheHit(QOnlineTranslator::Engine engine)
+{
+    QMutexLocker locker(&m_mutex);
+    ++m_engines[engine].cacheHits;
+}
+
+void QTranslationMetrics::recordCacheMiss(QOnlineTranslator::Engine engine)
+{
+    QMutexLocker locker(&m_mutex);
+    ++m_engines[engine].cacheMisses;
+}
+
+QByteArray QTranslationMetrics::toPrometheus() const
+{
+    static constexpr const char *stageNames[] = {"credentials", "language_detection", "translation", "transliteration", "dictionary"};
+    static_assert(std::size(stageNames) == QTranslationTimings::StagesCount);
+
+    const QMetaEnum engineEnum = QMetaEnum::fromType<QOnlineTranslator::Engine>();
+    const QMetaEnum errorEnum = QMetaEnum::fromType<QOnlineTranslator::TranslationError>();
+
+    QMutexLocker locker(&m_mutex);
+    QByteArray output;
+
+    output += "# HELP qonlinetranslator_translation_duration_seconds Time from the translation start to the finish.\n"
+              "# TYPE qonlinetranslator_translation_duration_seconds histogram\n";
+    for (int engine = 0; engine < engineEnum.keyCount(); ++engine) {
+        const QByteArray labels = QByteArrayLiteral("engine=\"") + engineEnum.valueToKey(engine) + '"';
+        writeHistogram(output, m_engines[engine].translationDuration, "qonlinetranslator_translation_duration_seconds", labels);
+    }
+
+    output += "# HELP qonlinetranslator_stage_duration_seconds Time spent on requests and parsing of a translation stage.\n"
+              "# TYPE qonlinetranslator_stage_duration_seconds histogram\n";
+    for (int engine = 0; engine < engineEnum.keyCount(); ++engine) {
+        for (int stage = 0; stage < QTranslationTimings::StagesCount; ++stage) {
+            const QByteArray labels = QByteArrayLiteral("engine=\"") + engineEnum.valueToKey(engine) + "\",stage=\"" + stageNames[stage] + '"';
+            writeHistogram(output, m_engines[engine].stageDurations[stage], "qonlinetranslator_stage_duration_seconds", labels);
+        }
+    }
+
+    output += "# HELP qonlinetranslator_translations_total Finished translations by error.\n"
+              "# TYPE qonlinetranslator_translations_total counter\n";
+    for (int engine = 0; engine < engineEnum.keyCount(); ++engine) {
+        for (int error = 0; error < errorEnum.keyCount(); ++error) {
+            output += QByteArrayLiteral("qonlinetranslator_translations_total{engine=\"") + engineEnum.valueToKey(engine) + "\",error=\"" + errorEnum.valueToKey(error) + "\"} "
+                + QByteArray::number(m_engines[engine].translations[error]) + '\n';
+        }
+    }
+
+    output += "# HELP qonlinetranslator_requests_total Sent requests.\n"
+              "# TYPE qonlinetranslator_requests_total counter\n";
+    for (int engine = 0; engine < engineEnum.keyCount(); ++engine) {
+        for (int stage = 0; stage < QTranslationTimings::StagesCount; ++stage) {
+            if (m_engines[engine].requests[stage] == 0)
+                continue;
+
+            output += QByteArrayLiteral("qonlinetranslator_requests_total{engine=\"") + engineEnum.valueToKey(engine) + "\",stage=\"" + stageNames[stage] + "\"} "
+                + QByteArray::number(m_engines[engine].requests[stage]) + '\n';
+        }
+    }
+
+    const auto writeCounter = [&](const char *name, const char *help, quint64 EngineMetrics::*counter) {
+        output += QByteArrayLiteral("# HELP ") + name + ' ' + help + "\n# TYPE " + name + " counter\n";
+        for (int engine = 0; engine < engineEnum.keyCount(); ++engine)
+            output += QByteArray(name) + "{engine=\"" + engineEnum.valueToKey(engine) + "\"} " + QByteArray::number(m_engines[engine].*counter) + '\n';
+    };
+    writeCounter("qonlinetranslator_sent_bytes_total", "Size of the requests bodies.", &EngineMetrics::bytesSent);
+    writeCounter("qonlinetranslator_received_bytes_total", "Size of the responses bodies.", &EngineMetrics::bytesReceived);
+    writeCounter("qonlinetranslator_cache_hits_total", "Dictionaries that were found in the cache.", &EngineMetrics::cacheHits);
+    writeCounter("qonlinetranslator_cache_misses_total", "Dictionaries that were not found in the cache.", &EngineMetrics::cacheMisses);
+
+    return output;
+}
+
+void QTranslationMetrics::reset()
+{
+    QMutexLocker locker(&m_mutex);
+    std::fill(std::begin(m_engines), std::end(m_engines), EngineMetrics());
+}
+
+void QTranslationMetrics::Histogram::record(qint64 microseconds)
+{
+    for (size_t i = 0; i < std::size(s_bucketBounds); ++i) {
+        if (microseconds <= s_bucketBounds[i]) {
+            ++buckets[i];
+            break;
+        }
+    }
+    ++count;
+    sum += microseconds;
+}
+
+void QTranslationMetrics::writeHistogram(QByteArray &output, const Histogram &histogram, const QByteArray &name, const QByteArray &labels)
+{
+    if (histogram.count == 0)
+        return;
+
+    // Buckets are stored separately, but exported cumulatively
+    quint64 cumulativeCount = 0;
+    for (size_t i = 0; i < std::size(s_bucketBounds); ++i) {
+        cumulativeCount += histogram.buckets[i];
+        output += name + "_bucket{" + labels + ",le=\"" + QByteArray::number(static_cast<double>(s_bucketBounds[i]) / 1e6) + "\"} " + QByteArray::number(cumulativeCount) + '\n';
+    }
+    output += name + "_bucket{" + labels + ",le=\"+Inf\"} " + QByteArray::number(histogram.count) + '\n';
+    output += name + "_sum{" + labels + "} " + QByteArray::number(static_cast<double>(histogram.sum) / 1e6, 'g', 12) + '\n';
+    output += name + "_count{" + labels + "} " + QByteArray::number(histogram.count) + '\n';
+}
@@ -0,0 +1,138 @@
+/*
+ *  Copyright © 2018-2023 Hennadii Chernyshchyk <genaloner@gmail.com>
+ *
+ *  This file is part of QOnlineTranslator.
+ *
+ *  QOnlineTranslator is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  QOnlineTranslator is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with QOnlineTranslator. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef QTRANSLATIONMETRICS_H
+#define QTRANSLATIONMETRICS_H
+
+#include "qonlinetranslator.h"
+
+#include <QMutex>
+
+#include <iterator>
+
+/**
+ * @brief Collects statistics of all translations in the application
+ *
+ * Each QOnlineTranslator records its translations here after QOnlineTranslator::finished() signal.
+ * The collected data can be exported in the Prometheus text format, e.g. to serve it on `/metrics`.
+ *
+ * Example:
+ * @code
+ * QOnlineTranslator translator;
+ * // Obtain translations
+ *
+ * QTextStream out(stdout);
+ * out << QTranslationMetrics::instance().toPrometheus();
+ * @endcode
+ *
+ * Possible output:
+ * @code
+ * // # HELP qonlinetranslator_translation_duration_seconds Time from the translation start to the finish.
+ * // # TYPE qonlinetranslator_translation_duration_seconds histogram
+ * // qonlinetranslator_translation_duration_seconds_bucket{engine="Google",le="0.005"} 0
+ * // ...
+ * // qonlinetranslator_translation_duration_seconds_bucket{engine="Google",le="+Inf"} 12
+ * // qonlinetranslator_translation_duration_seconds_sum{engine="Google"} 2.731
+ * // qonlinetranslator_translation_duration_seconds_count{engine="Google"} 12
+ * @endcode
+ *
+ * All methods are thread-safe.
+ */
+class QTranslationMetrics
+{
+    Q_DISABLE_COPY(QTranslationMetrics)
+
+public:
+    /**
+     * @brief Global metrics
+     *
+     * @return metrics that are used by all QOnlineTranslator objects
+     */
+    static QTranslationMetrics &instance();
+
+    /**
+     * @brief Record finished translation
+     *
+     * Called by QOnlineTranslator automatically.
+     *
+     * @param engine used engine
+     * @param error translation error
+     * @param timings translation time measurements
+     */
+    void recordTranslation(QOnlineTranslator::Engine engine, QOnlineTranslator::TranslationError error, const QTranslationTimings &timings);
+
+    /**
+     * @brief Record found cached dictionary
+     *
+     * @param engine engine of the cached data
+     */
+    void recordCacheHit(QOnlineTranslator::Engine engine);
+
+    /**
+     * @brief Record not found cached dictionary
+     *
+     * @param engine engine of the cached data
+     */
+    void recordCacheMiss(QOnlineTranslator::Engine engine);
+
+    /**
+     * @brief Export metrics
+     *
+     * @return metrics in the Prometheus text exposition format
+     */
+    QByteArray toPrometheus() const;
+
+    /**
+     * @brief Reset all metrics to zero
+     */
+    void reset();
+
+private:
+    QTranslationMetrics() = default;
+
+    // Upper bounds of the histograms buckets in microseconds
+    static constexpr qint64 s_bucketBounds[] = {5000, 10000, 25000, 50000, 100000, 250000, 500000, 1000000, 2500000, 5000000, 10000000};
+
+    struct Histogram {
+        void record(qint64 microseconds);
+
+        quint64 buckets[std::size(s_bucketBounds)]{};
+        quint64 count = 0;
+        qint64 sum = 0; // In microseconds
+    };
+
+    struct EngineMetrics {
+        Histogram translationDuration;
+        Histogram stageDurations[QTranslationTimings::StagesCount];
+        quint64 requests[QTranslationTimings::StagesCount]{};
+        quint64 translations[QOnlineTranslator::ParsingError + 1]{};
+        quint64 bytesSent = 0;
+        quint64 bytesReceived = 0;
+        quint64 cacheHits = 0;
+        quint64 cacheMisses = 0;
+    };
+
+    static void writeHistogram(QByteArray &output, const Histogram &histogram, const QByteArray &name, const QByteArray &labels);
+
+    mutable QMutex m_mutex;
+    EngineMetrics m_engines[QOnlineTranslator::Lingva + 1];
+};
+
+#endif // QTRANSLATIONMETRICS_H
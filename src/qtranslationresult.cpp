@@ -0,0 +1,121 @@
+/*
+ *  Copyright © 2018-2023 Hennadii Chernyshchyk <genaloner@gmail.com>
+ *
+ *  This file is part of QOnlineTranslator.
+ *
+ *  QOnlineTranslator is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  QOnlineTranslator is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with QOnlineTranslator. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "qtranslationresult.h"
+
+#include <QJsonArray>
+
+QTranslationResult::QTranslationResult()
+    : d(new QTranslationResultData)
+{
+}
+
+QTranslationResult::QTranslationResult(QSharedDataPointer<QTranslationResultData> data)
+    : d(qMove(data))
+{
+}
+
+QOnlineTranslator::Engine QTranslationResult::engine() const
+{
+    return d->engine;
+}
+
+const QString &QTranslationResult::source() const
+{
+    return d->source;
+}
+
+const QString &QTranslationResult::sourceTranslit() const
+{
+    return d->sourceTranslit;
+}
+
+const QString &QTranslationResult::sourceTranscription() const
+{
+    return d->sourceTranscription;
+}
+
+QOnlineTranslator::Language QTranslationResult::sourceLanguage() const
+{
+    return d->sourceLang;
+}
+
+const QString &QTranslationResult::translation() const
+{
+    return d->translation;
+}
+
+const QString &QTranslationResult::translationTranslit() const
+{
+    return d->translationTranslit;
+}
+
+QOnlineTranslator::Language QTranslationResult::translationLanguage() const
+{
+    return d->translationLang;
+}
+
+const QMap<QString, QVector<QOption>> &QTranslationResult::translationOptions() const
+{
+    return d->translationOptions;
+}
+
+const QMap<QString, QVector<QExample>> &QTranslationResult::examples() const
+{
+    return d->examples;
+}
+
+QOnlineTranslator::TranslationError QTranslationResult::error() const
+{
+    return d->error;
+}
+
+const QString &QTranslationResult::errorString() const
+{
+    return d->errorString;
+}
+
+QJsonObject QTranslationResult::toJson() const
+{
+    QJsonObject translationOptions;
+    for (auto it = d->translationOptions.cbegin(); it != d->translationOptions.cend(); ++it) {
+        QJsonArray arr;
+        for (const QOption &option : it.value())
+            arr.append(option.toJson());
+        translationOptions.insert(it.key(), arr);
+    }
+
+    QJsonObject examples;
+    for (auto it = d->examples.cbegin(); it != d->examples.cend(); ++it) {
+        QJsonArray arr;
+        for (const QExample &example : it.value())
+            arr.append(example.toJson());
+        examples.insert(it.key(), arr);
+    }
+
+    return {
+        {"examples", qMove(examples)},
+        {"source", d->source},
+        {"sourceTranscription", d->sourceTranscription},
+        {"sourceTranslit", d->sourceTranslit},
+        {"translation", d->translation},
+        {"translationOptions", qMove(translationOptions)},
+        {"translationTranslit", d->translationTranslit},
+    };
+}
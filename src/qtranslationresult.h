@@ -0,0 +1,181 @@
+/*
+ *  Copyright © 2018-2023 Hennadii Chernyshchyk <genaloner@gmail.com>
+ *
+ *  This file is part of QOnlineTranslator.
+ *
+ *  QOnlineTranslator is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  QOnlineTranslator is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with QOnlineTranslator. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef QTRANSLATIONRESULT_H
+#define QTRANSLATIONRESULT_H
+
+#include "qonlinetranslator.h"
+
+#include <QSharedData>
+
+/**
+ * @brief Data of QTranslationResult
+ *
+ * Filled by QOnlineTranslator during the translation and shared with the results returned by it.
+ */
+struct QTranslationResultData : QSharedData {
+    QString source;
+    QString sourceTranslit;
+    QString sourceTranscription;
+    QString translation;
+    QString translationTranslit;
+    QString errorString;
+
+    QMap<QString, QVector<QOption>> translationOptions;
+    QMap<QString, QVector<QExample>> examples;
+
+    QOnlineTranslator::Engine engine = QOnlineTranslator::Google;
+    QOnlineTranslator::Language sourceLang = QOnlineTranslator::NoLanguage;
+    QOnlineTranslator::Language translationLang = QOnlineTranslator::NoLanguage;
+    QOnlineTranslator::TranslationError error = QOnlineTranslator::NoError;
+};
+
+/**
+ * @brief Contains the result of a translation
+ *
+ * Can be obtained from the QOnlineTranslator object after QOnlineTranslator::finished() signal with QOnlineTranslator::result()
+ * or QOnlineTranslator::takeResult(). The object is immutable and implicitly shared, so copying it is cheap and copies can be
+ * stored, queued or passed to other threads independently of the translator.
+ *
+ * Example:
+ * @code
+ * QOnlineTranslator translator;
+ * connect(&translator, &QOnlineTranslator::finished, [&translator] {
+ *     const QTranslationResult result = translator.takeResult();
+ *     if (result.error() == QOnlineTranslator::NoError)
+ *         qInfo() << result.translation();
+ *     else
+ *         qCritical() << result.errorString();
+ * });
+ * @endcode
+ */
+class QTranslationResult
+{
+public:
+    /**
+     * @brief Create an empty result
+     */
+    QTranslationResult();
+
+    /**
+     * @brief Engine used for the translation
+     *
+     * @return engine
+     */
+    QOnlineTranslator::Engine engine() const;
+
+    /**
+     * @brief Source text
+     *
+     * @return source text
+     */
+    const QString &source() const;
+
+    /**
+     * @brief Source transliteration
+     *
+     * @return transliteration of the source text
+     */
+    const QString &sourceTranslit() const;
+
+    /**
+     * @brief Source transcription
+     *
+     * @return transcription of the source text
+     */
+    const QString &sourceTranscription() const;
+
+    /**
+     * @brief Source language
+     *
+     * @return language of the source text
+     */
+    QOnlineTranslator::Language sourceLanguage() const;
+
+    /**
+     * @brief Translated text
+     *
+     * @return translated text
+     */
+    const QString &translation() const;
+
+    /**
+     * @brief Translation transliteration
+     *
+     * @return transliteration of the translated text
+     */
+    const QString &translationTranslit() const;
+
+    /**
+     * @brief Translation language
+     *
+     * @return language of the translated text
+     */
+    QOnlineTranslator::Language translationLanguage() const;
+
+    /**
+     * @brief Translation options
+     *
+     * @return QMap whose key represents the type of speech, and the value is a QVector of translation options
+     * @sa QOption
+     */
+    const QMap<QString, QVector<QOption>> &translationOptions() const;
+
+    /**
+     * @brief Translation examples
+     *
+     * @return QMap whose key represents the type of speech, and the value is a QVector of translation examples
+     * @sa QExample
+     */
+    const QMap<QString, QVector<QExample>> &examples() const;
+
+    /**
+     * @brief Translation error
+     *
+     * If no error was found, returns QOnlineTranslator::NoError.
+     *
+     * @return translation error
+     */
+    QOnlineTranslator::TranslationError error() const;
+
+    /**
+     * @brief Translation error string
+     *
+     * @return human-readable description of the translation error
+     */
+    const QString &errorString() const;
+
+    /**
+     * @brief Converts the object to JSON
+     *
+     * @return JSON representation
+     */
+    QJsonObject toJson() const;
+
+private:
+    friend class QOnlineTranslator;
+
+    explicit QTranslationResult(QSharedDataPointer<QTranslationResultData> data);
+
+    QSharedDataPointer<QTranslationResultData> d;
+};
+
+Q_DECLARE_METATYPE(QTranslationResult)
+
+#endif // QTRANSLATIONRESULT_H
@@ -0,0 +1,75 @@
+/*
+ *  Copyright © 2018-2023 Hennadii Chernyshchyk <genaloner@gmail.com>
+ *
+ *  This file is part of QOnlineTranslator.
+ *
+ *  QOnlineTranslator is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  QOnlineTranslator is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with QOnlineTranslator. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "qtranslationtimings.h"
+
+QJsonObject QTranslationTimings::StageTimings::toJson() const
+{
+    QJsonObject object{
+        {"bytesReceived", bytesReceived},
+        {"bytesSent", bytesSent},
+        {"connectTime", connectTime},
+        {"downloadTime", downloadTime},
+        {"firstByteTime", firstByteTime},
+        {"parseTime", parseTime},
+        {"requests", requests},
+    };
+
+    return object;
+}
+
+int QTranslationTimings::requests() const
+{
+    int count = 0;
+    for (const StageTimings &stage : stages)
+        count += stage.requests;
+    return count;
+}
+
+qint64 QTranslationTimings::bytesSent() const
+{
+    qint64 bytes = 0;
+    for (const StageTimings &stage : stages)
+        bytes += stage.bytesSent;
+    return bytes;
+}
+
+qint64 QTranslationTimings::bytesReceived() const
+{
+    qint64 bytes = 0;
+    for (const StageTimings &stage : stages)
+        bytes += stage.bytesReceived;
+    return bytes;
+}
+
+QJsonObject QTranslationTimings::toJson() const
+{
+    QJsonObject object{
+        {"credentials", stages[Credentials].toJson()},
+        {"dictionary", stages[Dictionary].toJson()},
+        {"languageDetection", stages[LanguageDetection].toJson()},
+        {"queueWait", queueWait},
+        {"total", total},
+        {"translation", stages[Translation].toJson()},
+        {"transliteration", stages[Transliteration].toJson()},
+    };
+
+    return object;
+}
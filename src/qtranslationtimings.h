@@ -0,0 +1,146 @@
+/*
+ *  Copyright © 2018-2023 Hennadii Chernyshchyk <genaloner@gmail.com>
+ *
+ *  This file is part of QOnlineTranslator.
+ *
+ *  QOnlineTranslator is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  QOnlineTranslator is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with QOnlineTranslator. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef QTRANSLATIONTIMINGS_H
+#define QTRANSLATIONTIMINGS_H
+
+#include <QJsonObject>
+
+/**
+ * @brief Contains time measurements of the last translation
+ *
+ * Can be obtained from the QOnlineTranslator object after QOnlineTranslator::finished() signal.
+ * All times are in microseconds. Each stage can consist of several requests (e.g. translation of a long text is split into chunks),
+ * times of such requests are summed up.
+ *
+ * Qt does not report name resolution and TCP handshake separately, so they are included in the connection time
+ * when the engine uses HTTPS and in the time to first byte otherwise. Reused connections have zero connection time.
+ *
+ * Example:
+ * @code
+ * QOnlineTranslator translator;
+ * // Obtain translation
+ *
+ * QTextStream out(stdout);
+ * const QTranslationTimings timings = translator.timings();
+ * out << "Total: " << timings.total << endl;
+ * out << "Translation: " << timings.stages[QTranslationTimings::Translation].firstByteTime << endl;
+ * out << "Chunks: " << timings.stages[QTranslationTimings::Translation].requests << endl;
+ * @endcode
+ */
+struct QTranslationTimings {
+    /**
+     * @brief Stages of the translation that require separate requests
+     */
+    enum Stage {
+        Credentials,
+        LanguageDetection,
+        Translation,
+        Transliteration,
+        Dictionary,
+        StagesCount
+    };
+
+    /**
+     * @brief Measurements of a single stage
+     */
+    struct StageTimings {
+        /**
+         * @brief Number of sent requests
+         */
+        int requests = 0;
+
+        /**
+         * @brief Time from the request start to the established encrypted connection
+         */
+        qint64 connectTime = 0;
+
+        /**
+         * @brief Time from the request start to the received response headers
+         */
+        qint64 firstByteTime = 0;
+
+        /**
+         * @brief Time from the received response headers to the received response body
+         */
+        qint64 downloadTime = 0;
+
+        /**
+         * @brief Time spent on parsing the responses
+         */
+        qint64 parseTime = 0;
+
+        /**
+         * @brief Size of the requests bodies in bytes
+         */
+        qint64 bytesSent = 0;
+
+        /**
+         * @brief Size of the responses bodies in bytes
+         */
+        qint64 bytesReceived = 0;
+
+        /**
+         * @brief Converts the object to JSON
+         *
+         * @return JSON representation
+         */
+        QJsonObject toJson() const;
+    };
+
+    /**
+     * @brief Time from the translation start to the first request
+     */
+    qint64 queueWait = 0;
+
+    /**
+     * @brief Time from the translation start to the finish
+     */
+    qint64 total = 0;
+
+    /**
+     * @brief Measurements for each stage
+     */
+    StageTimings stages[StagesCount];
+
+    /**
+     * @brief Total number of sent requests
+     */
+    int requests() const;
+
+    /**
+     * @brief Total size of the requests bodies in bytes
+     */
+    qint64 bytesSent() const;
+
+    /**
+     * @brief Total size of the responses bodies in bytes
+     */
+    qint64 bytesReceived() const;
+
+    /**
+     * @brief Converts the object to JSON
+     *
+     * @return JSON representation
+     */
+    QJsonObject toJson() const;
+};
+
+#endif // QTRANSLATIONTIMINGS_H
@@ -0,0 +1,146 @@
+/*
+ *  Copyright © 2018-2023 Hennadii Chernyshchyk <genaloner@gmail.com>
+ *
+ *  This file is part of QOnlineTranslator.
+ *
+ *  QOnlineTranslator is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  QOnlineTranslator is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with QOnlineTranslator. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef QTRANSLATIONTRACER_H
+#define QTRANSLATIONTRACER_H
+
+#include "qonlinetranslator.h"
+
+/**
+ * @brief Describes a single operation of the translation
+ *
+ * Requests and parsing of their responses are nested into the translation span.
+ * Identifiers are unique within a single translation, the translation span always has identifier 1.
+ */
+struct QTranslationSpan {
+    /**
+     * @brief Type of the operation
+     */
+    enum Type {
+        /** Whole translation or language detection */
+        Translation,
+        /** Network request */
+        Request,
+        /** Parsing of the response */
+        Parsing
+    };
+
+    /**
+     * @brief Identifier of the span
+     */
+    int id = 0;
+
+    /**
+     * @brief Identifier of the parent span, 0 for the translation span
+     */
+    int parentId = 0;
+
+    /**
+     * @brief Type of the operation
+     */
+    Type type = Translation;
+
+    /**
+     * @brief Translator that performs the operation
+     */
+    const QOnlineTranslator *translator = nullptr;
+
+    /**
+     * @brief Used engine
+     */
+    QOnlineTranslator::Engine engine = QOnlineTranslator::Google;
+
+    /**
+     * @brief Stage of the request or parsing
+     */
+    QTranslationTimings::Stage stage = QTranslationTimings::Translation;
+
+    /**
+     * @brief Index of the text part for split translations, -1 if the stage is not split
+     */
+    int chunkIndex = -1;
+
+    /**
+     * @brief Size of the request body in bytes, available when the span is finished
+     */
+    qint64 bytesSent = 0;
+
+    /**
+     * @brief Size of the response body in bytes, available when the span is finished
+     */
+    qint64 bytesReceived = 0;
+
+    /**
+     * @brief Result of the operation, available when the span is finished
+     */
+    QOnlineTranslator::TranslationError error = QOnlineTranslator::NoError;
+};
+
+/**
+ * @brief Interface to receive spans of translations
+ *
+ * Can be used to pass stages of translations into a distributed tracing system.
+ * Methods are called synchronously from the thread of the translator, so the current time can be used as span time.
+ *
+ * Example:
+ * @code
+ * class LogTracer : public QTranslationTracer
+ * {
+ * public:
+ *     void spanStarted(const QTranslationSpan &span) override
+ *     {
+ *         m_timers[span.id].start();
+ *     }
+ *
+ *     void spanFinished(const QTranslationSpan &span) override
+ *     {
+ *         qInfo() << span.type << span.stage << span.chunkIndex << m_timers.take(span.id).elapsed();
+ *     }
+ *
+ * private:
+ *     QHash<int, QElapsedTimer> m_timers;
+ * };
+ *
+ * LogTracer tracer;
+ * QOnlineTranslator translator;
+ * translator.setTracer(&tracer);
+ * @endcode
+ */
+class QTranslationTracer
+{
+public:
+    virtual ~QTranslationTracer() = default;
+
+    /**
+     * @brief Called when operation is started
+     *
+     * @param span started operation
+     */
+    virtual void spanStarted(const QTranslationSpan &span) = 0;
+
+    /**
+     * @brief Called when operation is finished
+     *
+     * @param span finished operation
+     */
+    virtual void spanFinished(const QTranslationSpan &span) = 0;
+};
+
+#endif // QTRANSLATIONTRACER_H
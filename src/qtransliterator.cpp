@@ -0,0 +1,591 @@
+/*
+ *  Copyright © 2018-2023 Hennadii Chernyshchyk <genaloner@gmail.com>
+ *
+ *  This file is part of QOnlineTranslator.
+ *
+ *  QOnlineTranslator is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  QOnlineTranslator is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with QOnlineTranslator. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "qtransliterator.h"
+
+#include <algorithm>
+#include <iterator>
+
+constexpr QOnlineTranslator::Language QTransliterator::s_languages[] = {
+    QOnlineTranslator::Armenian,
+    QOnlineTranslator::Bashkir,
+    QOnlineTranslator::Belarusian,
+    QOnlineTranslator::Bulgarian,
+    QOnlineTranslator::Georgian,
+    QOnlineTranslator::Greek,
+    QOnlineTranslator::Hebrew,
+    QOnlineTranslator::HillMari,
+    QOnlineTranslator::Hindi,
+    QOnlineTranslator::Kazakh,
+    QOnlineTranslator::Kyrgyz,
+    QOnlineTranslator::Macedonian,
+    QOnlineTranslator::Marathi,
+    QOnlineTranslator::Mari,
+    QOnlineTranslator::Mongolian,
+    QOnlineTranslator::Nepali,
+    QOnlineTranslator::Russian,
+    QOnlineTranslator::SerbianCyrillic,
+    QOnlineTranslator::Tajik,
+    QOnlineTranslator::Tatar,
+    QOnlineTranslator::Udmurt,
+    QOnlineTranslator::Ukrainian,
+    QOnlineTranslator::Yiddish,
+};
+
+// Sorted by code units, combining marks are escaped
+constexpr QTransliterator::Rule QTransliterator::s_rules[] = {
+    // Greek
+    {u"\u037E", u"?"},
+    {u"\u0387", u";"},
+    {u"ΐ", u"i"},
+    {u"ά", u"a"},
+    {u"έ", u"e"},
+    {u"ή", u"i"},
+    {u"ί", u"i"},
+    {u"ΰ", u"y"},
+    {u"α", u"a"},
+    {u"αυ", u"av"},
+    {u"αύ", u"av"},
+    {u"β", u"v"},
+    {u"γ", u"g"},
+    {u"γγ", u"ng"},
+    {u"δ", u"d"},
+    {u"ε", u"e"},
+    {u"ευ", u"ev"},
+    {u"εύ", u"ev"},
+    {u"ζ", u"z"},
+    {u"η", u"i"},
+    {u"θ", u"th"},
+    {u"ι", u"i"},
+    {u"κ", u"k"},
+    {u"λ", u"l"},
+    {u"μ", u"m"},
+    {u"ν", u"n"},
+    {u"ξ", u"x"},
+    {u"ο", u"o"},
+    {u"ου", u"ou"},
+    {u"ού", u"ou"},
+    {u"π", u"p"},
+    {u"ρ", u"r"},
+    {u"ς", u"s"},
+    {u"σ", u"s"},
+    {u"τ", u"t"},
+    {u"υ", u"y"},
+    {u"φ", u"f"},
+    {u"χ", u"ch"},
+    {u"ψ", u"ps"},
+    {u"ω", u"o"},
+    {u"ϊ", u"i"},
+    {u"ϋ", u"y"},
+    {u"ό", u"o"},
+    {u"ύ", u"y"},
+    {u"ώ", u"o"},
+
+    // Cyrillic
+    {u"а", u"a"},
+    {u"б", u"b"},
+    {u"в", u"v"},
+    {u"г", u"g"},
+    {u"д", u"d"},
+    {u"е", u"e"},
+    {u"ж", u"zh"},
+    {u"з", u"z"},
+    {u"и", u"i"},
+    {u"й", u"y"},
+    {u"к", u"k"},
+    {u"л", u"l"},
+    {u"м", u"m"},
+    {u"н", u"n"},
+    {u"о", u"o"},
+    {u"п", u"p"},
+    {u"р", u"r"},
+    {u"с", u"s"},
+    {u"т", u"t"},
+    {u"у", u"u"},
+    {u"ф", u"f"},
+    {u"х", u"kh"},
+    {u"ц", u"ts"},
+    {u"ч", u"ch"},
+    {u"ш", u"sh"},
+    {u"щ", u"shch"},
+    {u"ъ", u""},
+    {u"ы", u"y"},
+    {u"ь", u""},
+    {u"э", u"e"},
+    {u"ю", u"yu"},
+    {u"я", u"ya"},
+    {u"ѐ", u"e"},
+    {u"ё", u"yo"},
+    {u"ђ", u"dj"},
+    {u"ѓ", u"gj"},
+    {u"є", u"ye"},
+    {u"ѕ", u"dz"},
+    {u"і", u"i"},
+    {u"ї", u"yi"},
+    {u"ј", u"j"},
+    {u"љ", u"lj"},
+    {u"њ", u"nj"},
+    {u"ћ", u"c"},
+    {u"ќ", u"kj"},
+    {u"ѝ", u"i"},
+    {u"ў", u"u"},
+    {u"џ", u"dzh"},
+    {u"ґ", u"g"},
+    {u"ғ", u"gh"},
+    {u"җ", u"zh"},
+    {u"ҙ", u"z"},
+    {u"қ", u"q"},
+    {u"ҡ", u"q"},
+    {u"ң", u"ng"},
+    {u"ҫ", u"s"},
+    {u"ү", u"u"},
+    {u"ұ", u"u"},
+    {u"ҳ", u"h"},
+    {u"ҷ", u"j"},
+    {u"һ", u"h"},
+    {u"ӑ", u"a"},
+    {u"ӓ", u"a"},
+    {u"ӗ", u"e"},
+    {u"ә", u"a"},
+    {u"ӣ", u"i"},
+    {u"ӧ", u"o"},
+    {u"ө", u"o"},
+    {u"ӯ", u"u"},
+    {u"ӱ", u"u"},
+    {u"ӹ", u"y"},
+
+    // Armenian
+    {u"՝", u","},
+    {u"ա", u"a"},
+    {u"բ", u"b"},
+    {u"գ", u"g"},
+    {u"դ", u"d"},
+    {u"ե", u"e"},
+    {u"զ", u"z"},
+    {u"է", u"e"},
+    {u"ը", u"y"},
+    {u"թ", u"t"},
+    {u"ժ", u"zh"},
+    {u"ի", u"i"},
+    {u"լ", u"l"},
+    {u"խ", u"kh"},
+    {u"ծ", u"ts"},
+    {u"կ", u"k"},
+    {u"հ", u"h"},
+    {u"ձ", u"dz"},
+    {u"ղ", u"gh"},
+    {u"ճ", u"ch"},
+    {u"մ", u"m"},
+    {u"յ", u"y"},
+    {u"ն", u"n"},
+    {u"շ", u"sh"},
+    {u"ո", u"o"},
+    {u"ու", u"u"},
+    {u"չ", u"ch"},
+    {u"պ", u"p"},
+    {u"ջ", u"j"},
+    {u"ռ", u"r"},
+    {u"ս", u"s"},
+    {u"վ", u"v"},
+    {u"տ", u"t"},
+    {u"ր", u"r"},
+    {u"ց", u"ts"},
+    {u"ւ", u"v"},
+    {u"փ", u"p"},
+    {u"ք", u"k"},
+    {u"օ", u"o"},
+    {u"ֆ", u"f"},
+    {u"և", u"ev"},
+    {u"։", u"."},
+
+    // Hebrew
+    {u"\u05B0", u""},
+    {u"\u05B1", u"e"},
+    {u"\u05B2", u"a"},
+    {u"\u05B3", u"o"},
+    {u"\u05B4", u"i"},
+    {u"\u05B5", u"e"},
+    {u"\u05B6", u"e"},
+    {u"\u05B7", u"a"},
+    {u"\u05B8", u"a"},
+    {u"\u05B9", u"o"},
+    {u"\u05BA", u"o"},
+    {u"\u05BB", u"u"},
+    {u"\u05BC", u""},
+    {u"\u05BD", u""},
+    {u"־", u"-"},
+    {u"\u05BF", u""},
+    {u"\u05C1", u""},
+    {u"\u05C2", u""},
+    {u"\u05C7", u"o"},
+    {u"א", u""},
+    {u"ב", u"v"},
+    {u"ב\u05BC", u"b"},
+    {u"ג", u"g"},
+    {u"ד", u"d"},
+    {u"ה", u"h"},
+    {u"ו", u"o"},
+    {u"ו\u05B9", u"o"},
+    {u"ו\u05BC", u"u"},
+    {u"וו", u"v"},
+    {u"ז", u"z"},
+    {u"ח", u"kh"},
+    {u"ט", u"t"},
+    {u"י", u"y"},
+    {u"ך", u"kh"},
+    {u"כ", u"kh"},
+    {u"כ\u05BC", u"k"},
+    {u"ל", u"l"},
+    {u"ם", u"m"},
+    {u"מ", u"m"},
+    {u"ן", u"n"},
+    {u"נ", u"n"},
+    {u"ס", u"s"},
+    {u"ע", u""},
+    {u"ף", u"f"},
+    {u"פ", u"f"},
+    {u"פ\u05BC", u"p"},
+    {u"ץ", u"ts"},
+    {u"צ", u"ts"},
+    {u"ק", u"k"},
+    {u"ר", u"r"},
+    {u"ש", u"sh"},
+    {u"ש\u05C1", u"sh"},
+    {u"ש\u05C2", u"s"},
+    {u"ת", u"t"},
+    {u"װ", u"v"},
+    {u"ױ", u"oy"},
+    {u"ײ", u"ey"},
+    {u"׳", u"'"},
+    {u"״", u"\""},
+
+    // Devanagari
+    {u"\u0901", u"n"},
+    {u"\u0902", u"n"},
+    {u"\u0903", u"h"},
+    {u"अ", u"a"},
+    {u"आ", u"aa"},
+    {u"इ", u"i"},
+    {u"ई", u"ee"},
+    {u"उ", u"u"},
+    {u"ऊ", u"oo"},
+    {u"ऋ", u"ri"},
+    {u"ऍ", u"e"},
+    {u"ए", u"e"},
+    {u"ऐ", u"ai"},
+    {u"ऑ", u"o"},
+    {u"ओ", u"o"},
+    {u"औ", u"au"},
+    {u"क", u"k"},
+    {u"क\u093C", u"q"},
+    {u"ख", u"kh"},
+    {u"ख\u093C", u"kh"},
+    {u"ग", u"g"},
+    {u"ग\u093C", u"gh"},
+    {u"घ", u"gh"},
+    {u"ङ", u"ng"},
+    {u"च", u"ch"},
+    {u"छ", u"chh"},
+    {u"ज", u"j"},
+    {u"ज\u093C", u"z"},
+    {u"झ", u"jh"},
+    {u"ञ", u"ny"},
+    {u"ट", u"t"},
+    {u"ठ", u"th"},
+    {u"ड", u"d"},
+    {u"ड\u093C", u"r"},
+    {u"ढ", u"dh"},
+    {u"ढ\u093C", u"rh"},
+    {u"ण", u"n"},
+    {u"त", u"t"},
+    {u"थ", u"th"},
+    {u"द", u"d"},
+    {u"ध", u"dh"},
+    {u"न", u"n"},
+    {u"प", u"p"},
+    {u"फ", u"ph"},
+    {u"फ\u093C", u"f"},
+    {u"ब", u"b"},
+    {u"भ", u"bh"},
+    {u"म", u"m"},
+    {u"य", u"y"},
+    {u"य\u093C", u"y"},
+    {u"र", u"r"},
+    {u"ल", u"l"},
+    {u"ळ", u"l"},
+    {u"व", u"v"},
+    {u"श", u"sh"},
+    {u"ष", u"sh"},
+    {u"स", u"s"},
+    {u"ह", u"h"},
+    {u"\u093C", u""},
+    {u"ऽ", u"'"},
+    {u"\u093E", u"aa"},
+    {u"\u093F", u"i"},
+    {u"\u0940", u"ee"},
+    {u"\u0941", u"u"},
+    {u"\u0942", u"oo"},
+    {u"\u0943", u"ri"},
+    {u"\u0945", u"e"},
+    {u"\u0947", u"e"},
+    {u"\u0948", u"ai"},
+    {u"\u0949", u"o"},
+    {u"\u094B", u"o"},
+    {u"\u094C", u"au"},
+    {u"\u094D", u""},
+    {u"ॐ", u"om"},
+    {u"क़", u"q"},
+    {u"ख़", u"kh"},
+    {u"ग़", u"gh"},
+    {u"ज़", u"z"},
+    {u"ड़", u"r"},
+    {u"ढ़", u"rh"},
+    {u"फ़", u"f"},
+    {u"य़", u"y"},
+    {u"।", u"."},
+    {u"॥", u"."},
+    {u"०", u"0"},
+    {u"१", u"1"},
+    {u"२", u"2"},
+    {u"३", u"3"},
+    {u"४", u"4"},
+    {u"५", u"5"},
+    {u"६", u"6"},
+    {u"७", u"7"},
+    {u"८", u"8"},
+    {u"९", u"9"},
+
+    // Georgian
+    {u"ა", u"a"},
+    {u"ბ", u"b"},
+    {u"გ", u"g"},
+    {u"დ", u"d"},
+    {u"ე", u"e"},
+    {u"ვ", u"v"},
+    {u"ზ", u"z"},
+    {u"თ", u"t"},
+    {u"ი", u"i"},
+    {u"კ", u"k'"},
+    {u"ლ", u"l"},
+    {u"მ", u"m"},
+    {u"ნ", u"n"},
+    {u"ო", u"o"},
+    {u"პ", u"p'"},
+    {u"ჟ", u"zh"},
+    {u"რ", u"r"},
+    {u"ს", u"s"},
+    {u"ტ", u"t'"},
+    {u"უ", u"u"},
+    {u"ფ", u"p"},
+    {u"ქ", u"k"},
+    {u"ღ", u"gh"},
+    {u"ყ", u"q'"},
+    {u"შ", u"sh"},
+    {u"ჩ", u"ch"},
+    {u"ც", u"ts"},
+    {u"ძ", u"dz"},
+    {u"წ", u"ts'"},
+    {u"ჭ", u"ch'"},
+    {u"ხ", u"kh"},
+    {u"ჯ", u"j"},
+    {u"ჰ", u"h"},
+};
+
+// Rules that override the common ones, sorted by language and code units
+constexpr QTransliterator::LanguageRule QTransliterator::s_languageRules[] = {
+    {QOnlineTranslator::Belarusian, {u"г", u"h"}},
+    {QOnlineTranslator::Belarusian, {u"ў", u"w"}},
+
+    {QOnlineTranslator::Bulgarian, {u"х", u"h"}},
+    {QOnlineTranslator::Bulgarian, {u"щ", u"sht"}},
+    {QOnlineTranslator::Bulgarian, {u"ъ", u"a"}},
+
+    {QOnlineTranslator::Macedonian, {u"х", u"h"}},
+    {QOnlineTranslator::Macedonian, {u"ц", u"c"}},
+
+    // Serbian has the official Latin alphabet
+    {QOnlineTranslator::SerbianCyrillic, {u"ж", u"ž"}},
+    {QOnlineTranslator::SerbianCyrillic, {u"х", u"h"}},
+    {QOnlineTranslator::SerbianCyrillic, {u"ц", u"c"}},
+    {QOnlineTranslator::SerbianCyrillic, {u"ч", u"č"}},
+    {QOnlineTranslator::SerbianCyrillic, {u"ш", u"š"}},
+    {QOnlineTranslator::SerbianCyrillic, {u"ђ", u"đ"}},
+    {QOnlineTranslator::SerbianCyrillic, {u"ћ", u"ć"}},
+    {QOnlineTranslator::SerbianCyrillic, {u"џ", u"dž"}},
+
+    {QOnlineTranslator::Ukrainian, {u"г", u"h"}},
+    {QOnlineTranslator::Ukrainian, {u"и", u"y"}},
+
+    // Yiddish writes vowels with letters
+    {QOnlineTranslator::Yiddish, {u"א\u05B8", u"o"}},
+    {QOnlineTranslator::Yiddish, {u"ו", u"u"}},
+    {QOnlineTranslator::Yiddish, {u"י", u"i"}},
+    {QOnlineTranslator::Yiddish, {u"י\u05B4", u"i"}},
+    {QOnlineTranslator::Yiddish, {u"ע", u"e"}},
+    {QOnlineTranslator::Yiddish, {u"פ", u"p"}},
+    {QOnlineTranslator::Yiddish, {u"פ\u05BF", u"f"}},
+    {QOnlineTranslator::Yiddish, {u"ת", u"s"}},
+    {QOnlineTranslator::Yiddish, {u"ײ\u05B7", u"ay"}},
+};
+
+bool QTransliterator::isSupported(QOnlineTranslator::Language language)
+{
+    return std::binary_search(std::begin(s_languages), std::end(s_languages), language);
+}
+
+QString QTransliterator::transliterate(const QString &text, QOnlineTranslator::Language language)
+{
+    if (!isSupported(language))
+        return {};
+
+    const auto *data = reinterpret_cast<const char16_t *>(text.utf16());
+    const int size = text.size();
+
+    QString result;
+    result.reserve(size + size / 2);
+    int index = 0;
+    while (index < size) {
+        // There are no rules for ASCII
+        if (data[index] < 0x80) {
+            result += QChar(data[index]);
+            ++index;
+            continue;
+        }
+
+        // Letters with points and digraphs are checked first
+        const char16_t source[] = {toLower(data[index]), index + 1 < size ? toLower(data[index + 1]) : u'\0'};
+        const Rule *rule = nullptr;
+        int sourceSize = 2;
+        if (index + 1 < size)
+            rule = findRule(language, {source, 2});
+        if (rule == nullptr) {
+            rule = findRule(language, {source, 1});
+            sourceSize = 1;
+        }
+        if (rule == nullptr) {
+            result += QChar(data[index]);
+            ++index;
+            continue;
+        }
+
+        // Dagesh and dots that change the reading of a Hebrew letter follow vowel points in the canonical order,
+        // they will be skipped as points on the next iterations
+        if (sourceSize == 1 && isHebrewLetter(data[index])) {
+            for (int i = index + 1; i < size && isHebrewPoint(data[i]); ++i) {
+                const char16_t letter[] = {data[index], data[i]};
+                if (const Rule *letterRule = findRule(language, {letter, 2})) {
+                    rule = letterRule;
+                    break;
+                }
+            }
+        }
+
+        // Replacement is written in upper case if the letter is a part of the word in upper case
+        const bool capitalize = source[0] != data[index];
+        const bool upperCase = capitalize && (isUpper(data, size, index - 1) || isUpper(data, size, index + 1));
+        appendReplacement(result, rule->replacement, capitalize, upperCase);
+
+        const char16_t firstCharacter = data[index];
+        index += sourceSize;
+        if (!isDevanagariConsonant(firstCharacter))
+            continue;
+
+        // Devanagari consonant is pronounced with the inherent vowel if it's not replaced by a vowel sign or suppressed by virama
+        if (index < size && data[index] == s_devanagariNukta)
+            ++index;
+        if (index < size && isDevanagariVowelSign(data[index]))
+            continue; // The sign will be transliterated on the next iteration
+        if (index < size && data[index] == s_devanagariVirama) {
+            ++index;
+            continue;
+        }
+
+        // The inherent vowel at the end of the word is not pronounced
+        if (index < size && isDevanagariLetter(data[index]))
+            result += QChar(s_devanagariInherentVowel);
+    }
+
+    return result;
+}
+
+const QTransliterator::Rule *QTransliterator::findRule(QOnlineTranslator::Language language, std::u16string_view source)
+{
+    const auto *languageRulesEnd = std::end(s_languageRules);
+    const auto *languageRule = std::lower_bound(std::begin(s_languageRules), languageRulesEnd, source, [language](const LanguageRule &rule, std::u16string_view value) {
+        return rule.language < language || (rule.language == language && rule.rule.source < value);
+    });
+    if (languageRule != languageRulesEnd && languageRule->language == language && languageRule->rule.source == source)
+        return &languageRule->rule;
+
+    const auto *rulesEnd = std::end(s_rules);
+    const auto *rule = std::lower_bound(std::begin(s_rules), rulesEnd, source, [](const Rule &rule, std::u16string_view value) {
+        return rule.source < value;
+    });
+    if (rule != rulesEnd && rule->source == source)
+        return rule;
+
+    return nullptr;
+}
+
+void QTransliterator::appendReplacement(QString &text, std::u16string_view replacement, bool capitalize, bool upperCase)
+{
+    for (size_t i = 0; i < replacement.size(); ++i) {
+        const QChar character(replacement[i]);
+        if (upperCase || (capitalize && i == 0))
+            text += character.toUpper();
+        else
+            text += character;
+    }
+}
+
+bool QTransliterator::isUpper(const char16_t *data, int size, int index)
+{
+    return index >= 0 && index < size && QChar::isUpper(data[index]);
+}
+
+bool QTransliterator::isHebrewLetter(char16_t character)
+{
+    return character >= 0x05D0 && character <= 0x05F2;
+}
+
+bool QTransliterator::isHebrewPoint(char16_t character)
+{
+    return character >= 0x05B0 && character <= 0x05C7 && character != 0x05BE && character != 0x05C0 && character != 0x05C3 && character != 0x05C6;
+}
+
+bool QTransliterator::isDevanagariConsonant(char16_t character)
+{
+    return (character >= 0x0915 && character <= 0x0939) || (character >= 0x0958 && character <= 0x095F);
+}
+
+bool QTransliterator::isDevanagariVowelSign(char16_t character)
+{
+    return character >= 0x093E && character <= 0x094C;
+}
+
+bool QTransliterator::isDevanagariLetter(char16_t character)
+{
+    // Signs that modify the vowel (candrabindu, anusvara and visarga) are pronounced after it
+    return (character >= 0x0901 && character <= 0x0939) || (character >= 0x0958 && character <= 0x095F);
+}
+
+char16_t QTransliterator::toLower(char16_t character)
+{
+    return static_cast<char16_t>(QChar::toLower(character));
+}
@@ -0,0 +1,94 @@
+/*
+ *  Copyright © 2018-2023 Hennadii Chernyshchyk <genaloner@gmail.com>
+ *
+ *  This file is part of QOnlineTranslator.
+ *
+ *  QOnlineTranslator is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  QOnlineTranslator is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with QOnlineTranslator. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef QTRANSLITERATOR_H
+#define QTRANSLITERATOR_H
+
+#include "qonlinetranslator.h"
+
+#include <string_view>
+
+/**
+ * @brief Transliterates text into Latin script without network requests
+ *
+ * Uses rule tables for Cyrillic, Greek, Armenian, Georgian, Hebrew and Devanagari scripts
+ * with language-specific rules where the reading of a letter differs between languages (for example, Ukrainian "г" is "h").
+ * Devanagari consonants get the inherent vowel unless it's suppressed by a vowel sign, virama or the end of the word.
+ * Hebrew and Yiddish vowels are taken from points when the text has them, so unpointed text is transliterated approximately.
+ * Characters without rules (punctuation, digits, other scripts) are copied as is.
+ *
+ * Example:
+ * @code
+ * if (QTransliterator::isSupported(QOnlineTranslator::Russian))
+ *     qInfo() << QTransliterator::transliterate("Привет, мир", QOnlineTranslator::Russian); // Privet, mir
+ * @endcode
+ */
+class QTransliterator
+{
+public:
+    /**
+     * @brief Check if transliteration is supported for the language
+     *
+     * @param language language
+     * @return `true` if the text in the language can be transliterated
+     */
+    static bool isSupported(QOnlineTranslator::Language language);
+
+    /**
+     * @brief Transliterate text
+     *
+     * @param text text to transliterate
+     * @param language language of the text
+     * @return transliterated text or empty string if the language is not supported
+     */
+    static QString transliterate(const QString &text, QOnlineTranslator::Language language);
+
+private:
+    // Source is one or two lower case code units (a letter with a point or a digraph)
+    struct Rule {
+        std::u16string_view source;
+        std::u16string_view replacement;
+    };
+
+    struct LanguageRule {
+        QOnlineTranslator::Language language;
+        Rule rule;
+    };
+
+    static const Rule *findRule(QOnlineTranslator::Language language, std::u16string_view source);
+    static void appendReplacement(QString &text, std::u16string_view replacement, bool capitalize, bool upperCase);
+    static bool isUpper(const char16_t *data, int size, int index);
+    static bool isHebrewLetter(char16_t character);
+    static bool isHebrewPoint(char16_t character);
+    static bool isDevanagariConsonant(char16_t character);
+    static bool isDevanagariVowelSign(char16_t character);
+    static bool isDevanagariLetter(char16_t character);
+    static char16_t toLower(char16_t character);
+
+    // All tables are sorted
+    static const QOnlineTranslator::Language s_languages[];
+    static const Rule s_rules[];
+    static const LanguageRule s_languageRules[];
+
+    static constexpr char16_t s_devanagariNukta = 0x093C;
+    static constexpr char16_t s_devanagariVirama = 0x094D;
+    static constexpr char16_t s_devanagariInherentVowel = u'a';
+};
+
+#endif // QTRANSLITERATOR_H
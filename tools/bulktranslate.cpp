@@ -0,0 +1,425 @@
+/*
+ *  Copyright © 2018-2023 Hennadii Chernyshchyk <genaloner@gmail.com>
+ *
+ *  This file is part of QOnlineTranslator.
+ *
+ *  QOnlineTranslator is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  QOnlineTranslator is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with QOnlineTranslator. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "qonlinetranslator.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMap>
+#include <QMetaEnum>
+#include <QSaveFile>
+#include <QTextStream>
+#include <QTimer>
+#include <QVector>
+
+namespace {
+// Translates input lines in parallel, but writes them in the input order
+class BulkTranslation : public QObject
+{
+public:
+    enum Format {
+        Text,
+        Jsonl
+    };
+
+    struct Settings {
+        QOnlineTranslator::Engine engine = QOnlineTranslator::Google;
+        QOnlineTranslator::Language translationLang = QOnlineTranslator::Auto;
+        QOnlineTranslator::Language sourceLang = QOnlineTranslator::Auto;
+        QString engineUrl;
+        QByteArray engineApiKey;
+        Format format = Text;
+        QString field;
+        int concurrency = 4;
+        qreal rate = 0;
+        QString checkpointPath;
+    };
+
+    BulkTranslation(Settings settings, QFile *input, QFile *output)
+        : m_settings(qMove(settings))
+        , m_input(input)
+        , m_output(output)
+        , m_maxBuffered(m_settings.concurrency * 4)
+    {
+        for (int i = 0; i < m_settings.concurrency; ++i) {
+            auto *translator = new QOnlineTranslator(this);
+            translator->setEngineUrl(m_settings.engine, m_settings.engineUrl);
+            translator->setEngineApiKey(m_settings.engine, m_settings.engineApiKey);
+
+            // Only translation is written
+            translator->setSourceTranslitEnabled(false);
+            translator->setTranslationTranslitEnabled(false);
+            translator->setSourceTranscriptionEnabled(false);
+            translator->setTranslationOptionsEnabled(false);
+            translator->setExamplesEnabled(false);
+
+            connect(translator, &QOnlineTranslator::finished, this, [this, translator] {
+                processTranslation(translator);
+            });
+            m_idleTranslators.append(translator);
+        }
+
+        m_pumpTimer.setSingleShot(true);
+        connect(&m_pumpTimer, &QTimer::timeout, this, &BulkTranslation::pump);
+    }
+
+    // Skips lines that were written by the interrupted run
+    bool restoreCheckpoint()
+    {
+        // Output of the previous run without checkpoint is overwritten
+        QFile checkpoint(m_settings.checkpointPath);
+        if (!checkpoint.exists()) {
+            if (!m_output->resize(0)) {
+                m_errorString = QStringLiteral("Unable to truncate output: %1").arg(m_output->errorString());
+                return false;
+            }
+            return true;
+        }
+
+        if (!checkpoint.open(QIODevice::ReadOnly)) {
+            m_errorString = QStringLiteral("Unable to read checkpoint %1: %2").arg(checkpoint.fileName(), checkpoint.errorString());
+            return false;
+        }
+
+        const QJsonObject state = QJsonDocument::fromJson(checkpoint.readAll()).object();
+        const qint64 lines = state.value(QStringLiteral("lines")).toVariant().toLongLong();
+        const qint64 outputSize = state.value(QStringLiteral("outputSize")).toVariant().toLongLong();
+
+        // Output may contain a partially written part after the checkpoint
+        if (m_output->size() < outputSize || !m_output->resize(outputSize) || !m_output->seek(outputSize)) {
+            m_errorString = QStringLiteral("Output does not match checkpoint %1").arg(checkpoint.fileName());
+            return false;
+        }
+
+        for (qint64 i = 0; i < lines; ++i) {
+            if (m_input->readLine().isEmpty()) {
+                m_errorString = QStringLiteral("Input does not match checkpoint %1").arg(checkpoint.fileName());
+                return false;
+            }
+        }
+
+        m_nextIndex = lines;
+        m_nextWriteIndex = lines;
+        return true;
+    }
+
+    void start()
+    {
+        m_rateTimer.start();
+        pump();
+    }
+
+    QString errorString() const
+    {
+        return m_errorString;
+    }
+
+    int failedCount() const
+    {
+        return m_failedCount;
+    }
+
+private:
+    void pump()
+    {
+        while (!m_inputFinished && !m_idleTranslators.isEmpty() && m_runningTranslators.size() + m_results.size() < m_maxBuffered) {
+            if (m_settings.rate > 0) {
+                const qint64 delay = m_nextStartTime - m_rateTimer.elapsed();
+                if (delay > 0) {
+                    m_pumpTimer.start(static_cast<int>(delay));
+                    return;
+                }
+                m_nextStartTime = qMax(m_nextStartTime, m_rateTimer.elapsed()) + static_cast<qint64>(1000 / m_settings.rate);
+            }
+
+            QByteArray line = m_input->readLine();
+            if (line.isEmpty()) {
+                m_inputFinished = true;
+                break;
+            }
+            if (line.endsWith('\n'))
+                line.chop(1);
+            if (line.endsWith('\r'))
+                line.chop(1);
+
+            const qint64 index = m_nextIndex++;
+            QString text;
+            QJsonObject object;
+            if (m_settings.format == Jsonl) {
+                QJsonParseError error;
+                object = QJsonDocument::fromJson(line, &error).object();
+                if (error.error != QJsonParseError::NoError) {
+                    object.insert(QStringLiteral("error"), QStringLiteral("Unable to parse line: %1").arg(error.errorString()));
+                    addResult(index, QJsonDocument(object).toJson(QJsonDocument::Compact));
+                    ++m_failedCount;
+                    continue;
+                }
+                text = object.value(m_settings.field).toString();
+            } else {
+                text = QString::fromUtf8(line);
+            }
+
+            // Nothing to translate
+            if (text.trimmed().isEmpty()) {
+                addResult(index, m_settings.format == Jsonl ? QJsonDocument(object).toJson(QJsonDocument::Compact) : QByteArray());
+                continue;
+            }
+
+            QOnlineTranslator *translator = m_idleTranslators.takeLast();
+            m_runningTranslators.insert(translator, {index, object});
+            translator->translate(text, m_settings.engine, m_settings.translationLang, m_settings.sourceLang, QOnlineTranslator::English);
+        }
+
+        if (!m_inputFinished || !m_runningTranslators.isEmpty())
+            return;
+
+        if (!m_errorString.isEmpty()) {
+            QCoreApplication::exit(1);
+            return;
+        }
+
+        if (!m_settings.checkpointPath.isEmpty() && m_checkpointIndex != m_nextWriteIndex) {
+            saveCheckpoint();
+            if (!m_errorString.isEmpty()) {
+                QCoreApplication::exit(1);
+                return;
+            }
+        }
+
+        QCoreApplication::exit(m_failedCount == 0 ? 0 : 2);
+    }
+
+    void processTranslation(QOnlineTranslator *translator)
+    {
+        const auto [index, object] = m_runningTranslators.take(translator);
+        QByteArray result;
+        if (m_settings.format == Jsonl) {
+            QJsonObject translatedObject = object;
+            if (translator->error() == QOnlineTranslator::NoError)
+                translatedObject.insert(QStringLiteral("translation"), translator->translation());
+            else
+                translatedObject.insert(QStringLiteral("error"), translator->errorString());
+            result = QJsonDocument(translatedObject).toJson(QJsonDocument::Compact);
+        } else if (translator->error() == QOnlineTranslator::NoError) {
+            // Keep one line per input line
+            result = translator->translation().replace('\n', ' ').toUtf8();
+        }
+
+        if (translator->error() != QOnlineTranslator::NoError) {
+            QTextStream(stderr) << "Line " << index + 1 << ": " << translator->errorString() << '\n';
+            ++m_failedCount;
+        }
+
+        addResult(index, result);
+        m_idleTranslators.append(translator);
+
+        // Do not start the next translation from the signal of the previous one
+        QTimer::singleShot(0, this, &BulkTranslation::pump);
+    }
+
+    void addResult(qint64 index, const QByteArray &result)
+    {
+        m_results.insert(index, result);
+
+        bool written = false;
+        for (auto it = m_results.begin(); it != m_results.end() && it.key() == m_nextWriteIndex; it = m_results.erase(it)) {
+            if (m_output->write(it.value() + '\n') == -1) {
+                fail(QStringLiteral("Unable to write output: %1").arg(m_output->errorString()));
+                return;
+            }
+            ++m_nextWriteIndex;
+            written = true;
+        }
+
+        if (written && !m_settings.checkpointPath.isEmpty() && m_nextWriteIndex - m_checkpointIndex >= s_checkpointInterval)
+            saveCheckpoint();
+    }
+
+    void saveCheckpoint()
+    {
+        if (!m_output->flush()) {
+            fail(QStringLiteral("Unable to write output: %1").arg(m_output->errorString()));
+            return;
+        }
+
+        // Replace the checkpoint atomically to not lose it on interruption
+        QSaveFile checkpoint(m_settings.checkpointPath);
+        const QJsonObject state{
+            {"lines", m_nextWriteIndex},
+            {"outputSize", m_output->pos()},
+        };
+        if (!checkpoint.open(QIODevice::WriteOnly) || checkpoint.write(QJsonDocument(state).toJson()) == -1 || !checkpoint.commit()) {
+            fail(QStringLiteral("Unable to write checkpoint %1: %2").arg(checkpoint.fileName(), checkpoint.errorString()));
+            return;
+        }
+        m_checkpointIndex = m_nextWriteIndex;
+    }
+
+    void fail(const QString &errorString)
+    {
+        m_errorString = errorString;
+        m_inputFinished = true;
+        for (QOnlineTranslator *translator : m_runningTranslators.keys())
+            translator->abort();
+    }
+
+    struct RunningTranslation {
+        qint64 index;
+        QJsonObject object;
+    };
+
+    static constexpr qint64 s_checkpointInterval = 100;
+
+    const Settings m_settings;
+    QFile *m_input;
+    QFile *m_output;
+    const int m_maxBuffered;
+
+    QVector<QOnlineTranslator *> m_idleTranslators;
+    QHash<QOnlineTranslator *, RunningTranslation> m_runningTranslators;
+    QMap<qint64, QByteArray> m_results; // Finished lines that wait for the previous ones
+
+    qint64 m_nextIndex = 0;
+    qint64 m_nextWriteIndex = 0;
+    qint64 m_checkpointIndex = 0;
+    bool m_inputFinished = false;
+    int m_failedCount = 0;
+    QString m_errorString;
+
+    QElapsedTimer m_rateTimer;
+    qint64 m_nextStartTime = 0;
+    QTimer m_pumpTimer;
+};
+
+template<typename T>
+bool parseEnum(const QString &key, T &value)
+{
+    bool ok;
+    value = static_cast<T>(QMetaEnum::fromType<T>().keyToValue(key.toLatin1(), &ok));
+    return ok;
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName(QStringLiteral("QOnlineTranslatorBulkTranslate"));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Translates a text or JSONL file line by line"));
+    parser.addHelpOption();
+    parser.addPositionalArgument(QStringLiteral("input"), QStringLiteral("Input file, \"-\" to read from the standard input."));
+    const QCommandLineOption outputOption({QStringLiteral("o"), QStringLiteral("output")}, QStringLiteral("Output file, the standard output if not set."), QStringLiteral("file"));
+    const QCommandLineOption engineOption({QStringLiteral("e"), QStringLiteral("engine")}, QStringLiteral("Translation engine."), QStringLiteral("engine"), QStringLiteral("Google"));
+    const QCommandLineOption engineUrlOption(QStringLiteral("engine-url"), QStringLiteral("Engine instance URL."), QStringLiteral("url"));
+    const QCommandLineOption engineApiKeyOption(QStringLiteral("engine-api-key"), QStringLiteral("Engine API key."), QStringLiteral("key"));
+    const QCommandLineOption translationOption({QStringLiteral("t"), QStringLiteral("translation")}, QStringLiteral("Translation language, e.g. Russian."), QStringLiteral("language"), QStringLiteral("Auto"));
+    const QCommandLineOption sourceOption({QStringLiteral("s"), QStringLiteral("source")}, QStringLiteral("Source language, detected automatically if not set."), QStringLiteral("language"), QStringLiteral("Auto"));
+    const QCommandLineOption formatOption({QStringLiteral("f"), QStringLiteral("format")}, QStringLiteral("Input format: text or jsonl."), QStringLiteral("format"), QStringLiteral("text"));
+    const QCommandLineOption fieldOption(QStringLiteral("field"), QStringLiteral("JSONL field with the text to translate."), QStringLiteral("name"), QStringLiteral("text"));
+    const QCommandLineOption concurrencyOption({QStringLiteral("j"), QStringLiteral("concurrency")}, QStringLiteral("Number of parallel translations."), QStringLiteral("count"), QStringLiteral("4"));
+    const QCommandLineOption rateOption({QStringLiteral("r"), QStringLiteral("rate")}, QStringLiteral("Maximum translations per second, unlimited if not set."), QStringLiteral("rate"), QStringLiteral("0"));
+    const QCommandLineOption checkpointOption({QStringLiteral("c"), QStringLiteral("checkpoint")}, QStringLiteral("File to save progress to and resume from."), QStringLiteral("file"));
+    parser.addOptions({outputOption, engineOption, engineUrlOption, engineApiKeyOption, translationOption, sourceOption, formatOption, fieldOption, concurrencyOption, rateOption, checkpointOption});
+    parser.process(app);
+
+    QTextStream err(stderr);
+    if (parser.positionalArguments().size() != 1) {
+        err << "Expected one input file\n";
+        return 1;
+    }
+
+    BulkTranslation::Settings settings;
+    if (!parseEnum(parser.value(engineOption), settings.engine)) {
+        err << "Unknown engine: " << parser.value(engineOption) << '\n';
+        return 1;
+    }
+    if (!parseEnum(parser.value(translationOption), settings.translationLang) || !parseEnum(parser.value(sourceOption), settings.sourceLang)) {
+        err << "Unknown language\n";
+        return 1;
+    }
+    if (parser.value(formatOption) == QLatin1String("jsonl")) {
+        settings.format = BulkTranslation::Jsonl;
+    } else if (parser.value(formatOption) != QLatin1String("text")) {
+        err << "Unknown format: " << parser.value(formatOption) << '\n';
+        return 1;
+    }
+    settings.engineUrl = parser.value(engineUrlOption);
+    settings.engineApiKey = parser.value(engineApiKeyOption).toUtf8();
+    settings.field = parser.value(fieldOption);
+    settings.concurrency = qMax(parser.value(concurrencyOption).toInt(), 1);
+    settings.rate = parser.value(rateOption).toDouble();
+    settings.checkpointPath = parser.value(checkpointOption);
+
+    QFile input;
+    bool inputOpened;
+    const QString inputPath = parser.positionalArguments().constFirst();
+    if (inputPath == QLatin1String("-")) {
+        inputOpened = input.open(stdin, QIODevice::ReadOnly);
+    } else {
+        input.setFileName(inputPath);
+        inputOpened = input.open(QIODevice::ReadOnly);
+    }
+    if (!inputOpened) {
+        err << "Unable to open " << inputPath << ": " << input.errorString() << '\n';
+        return 1;
+    }
+
+    // Resuming rewrites the output after the checkpoint, so it should be a regular file
+    QFile output;
+    bool outputOpened;
+    if (parser.isSet(outputOption)) {
+        output.setFileName(parser.value(outputOption));
+        outputOpened = output.open(settings.checkpointPath.isEmpty() ? QIODevice::WriteOnly | QIODevice::Truncate : QIODevice::ReadWrite);
+    } else if (!settings.checkpointPath.isEmpty()) {
+        err << "Checkpoint requires an output file\n";
+        return 1;
+    } else {
+        outputOpened = output.open(stdout, QIODevice::WriteOnly);
+    }
+    if (!outputOpened) {
+        err << "Unable to open output: " << output.errorString() << '\n';
+        return 1;
+    }
+
+    BulkTranslation translation(settings, &input, &output);
+    if (!settings.checkpointPath.isEmpty() && !translation.restoreCheckpoint()) {
+        err << translation.errorString() << '\n';
+        return 1;
+    }
+
+    QTimer::singleShot(0, &translation, [&translation] {
+        translation.start();
+    });
+    const int exitCode = QCoreApplication::exec();
+
+    output.flush();
+    if (!translation.errorString().isEmpty())
+        err << translation.errorString() << '\n';
+    else if (translation.failedCount() != 0)
+        err << translation.failedCount() << " lines were not translated\n";
+
+    return exitCode;
+}